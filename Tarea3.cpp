@@ -2,11 +2,47 @@
 #include <vector>
 #include <random>
 #include <chrono>
-#include <thread>
 #include <cmath>
 #include <limits>
 #include <algorithm>
 #include <iomanip>
+#include <queue>
+#include <string>
+#include <cstdlib>
+#include <cstdint>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/uio.h>
+#include <condition_variable>
+#include <memory>
 
 using namespace std;
 
@@ -22,538 +58,6985 @@ const string COLOR_ERROR = "\033[31m";  // Rojo para errores
 const string COLOR_FALLO = "\033[35m";  // Magenta para fallos de página
 const string COLOR_RESET = "\033[0m";   // Resetear color
 
+// Direcciones virtuales de 48 bits: con páginas de 4 KB un proceso tiene hasta 2^36 páginas
+const int BITS_PAGINA_VIRTUAL = 36;
+const uint64_t BYTES_ESPACIO_VIRTUAL = 1ULL << 48;
+
+// Una página enorme cubre 2^9 páginas base (2 MB con páginas de 4 KB), lo mismo que una
+// hoja de la tabla de páginas multinivel
+const int BITS_ENORME = 9;
+const int PAGINAS_ENORME = 1 << BITS_ENORME;
+
+// Tiempo de un acceso a memoria que acierta, para el rendimiento estimado (100 ns)
+const double TIEMPO_ACCESO_US = 0.1;
+
+// Modelos de acceso a memoria de cada proceso (ver GeneradorCarga)
+enum class ModeloCarga {
+    FORZADO,                    // Primera página en SWAP que se encuentre (fuerza fallos; comportamiento original)
+    UNIFORME,                   // Página al azar con igual probabilidad
+    ZIPF,                       // Conjunto caliente con popularidad Zipf
+    CONJUNTO,                   // Conjunto de trabajo que se desplaza con el tiempo
+    SECUENCIAL,                 // Recorrido secuencial circular
+    MIXTA                       // Fases que alternan secuencial, Zipf y conjunto de trabajo
+};
+
+// Configuración completa de una simulación
+struct ConfiguracionSimulacion {
+    uint64_t memoria_fisica = 0;         // Tamaño de la memoria física en bytes
+    uint64_t tamano_pagina = 0;          // Tamaño de cada página en bytes (múltiplo de 4 KB)
+    uint64_t proceso_min = 0;            // Tamaño mínimo de proceso en bytes
+    uint64_t proceso_max = 0;            // Tamaño máximo de proceso en bytes
+    unsigned int semilla = 0;            // Semilla del generador (misma semilla = misma simulación)
+
+    // Tasas de eventos en eventos por segundo de tiempo simulado
+    double tasa_llegadas = 0.5;          // Creación de procesos (antes: cada 2 segundos)
+    double tasa_finalizaciones = 0.2;    // Finalización de procesos (antes: cada 5 segundos)
+    double tasa_accesos = 0.2;           // Accesos a memoria (antes: cada 5 segundos)
+    bool intervalos_poisson = false;     // true: intervalos exponenciales, false: intervalos fijos
+    double inicio_periodicos = 10.0;     // Tiempo simulado en que comienzan finalizaciones y accesos
+    double duracion = 60.0;              // Duración total en segundos simulados
+    int max_procesos = 0;                // Máximo de procesos a crear (0 = sin límite)
+
+    string politica = "fifo";            // Política de reemplazo: fifo, lru, clock, 2q, arc, opt
+    string archivo_traza;                // Traza binaria a reproducir (vacío = carga sintética)
+
+    // Generador de carga sintética
+    ModeloCarga modelo_carga = ModeloCarga::FORZADO;
+    double zipf_exponente = 0.99;        // Exponente s de Zipf (mayor = conjunto caliente más pequeño)
+    double fraccion_ventana = 0.2;       // Tamaño del conjunto de trabajo (fracción de las páginas)
+    int accesos_por_deriva = 50;         // Accesos entre cada avance del conjunto de trabajo
+    int accesos_por_fase = 1000;         // Accesos por fase en el modelo mixto
+
+    // Registro: nivel de detalle del texto ("silencio", "resumen", "eventos" o "detalle")
+    // y archivo de eventos binario opcional
+    string nivel_registro = "detalle";
+    string archivo_registro_binario;
+    string archivo_registro;             // Texto del registro a un archivo ("" = pantalla)
+
+    // Métricas: prefijo de los archivos (prefijo.csv y prefijo.prom; "" = sin métricas)
+    // y cada cuántos segundos simulados se toma una instantánea
+    string prefijo_metricas;
+    double intervalo_metricas = 1.0;
+
+    // Modo contenido: cada marco guarda los bytes de su página y SWAP es un archivo real
+    // ("" = SWAP solo contable). Las expulsiones se agrupan en lotes de lote_swap páginas
+    // y la E/S la hacen hilos_es hilos; swap_directo usa O_DIRECT (sin caché de páginas).
+    string archivo_swap;
+    int lote_swap = 16;
+    int hilos_es = 4;
+    bool swap_directo = false;
+
+    // Caché comprimida (como zswap) delante del archivo de SWAP: presupuesto en MB
+    // (0 = sin caché) y fracción de la página que puede ocupar una página comprimida
+    // (las que no bajan de ella van directo al archivo)
+    int cache_comprimida_mb = 0;
+    double umbral_compresion = 0.75;
+
+    // Lectura anticipada tras un fallo: máximo de páginas extra por fallo (0 = sin
+    // anticipación) y de dónde salen: "virtual" (páginas siguientes del proceso) o
+    // "swap" (páginas del proceso en las ranuras de SWAP siguientes)
+    int paginas_anticipacion = 0;
+    string modo_anticipacion = "virtual";
+
+    // Recuperación en segundo plano (como kswapd): marcas de marcos libres en % de la RAM
+    // (marca_alta = 0 la desactiva). Bajo la marca baja se despierta el reclamador, que
+    // expulsa hasta lote_recuperacion páginas cada intervalo_recuperacion segundos
+    // simulados hasta llegar a la alta; bajo la mínima los fallos expulsan ellos mismos.
+    double marca_min = 0.0;
+    double marca_baja = 0.0;
+    double marca_alta = 0.0;
+    int lote_recuperacion = 32;
+    double intervalo_recuperacion = 0.01;
+
+    // Páginas compartidas: probabilidad de que una llegada sea un fork de un proceso
+    // activo (comparte todas sus páginas con copia en escritura), páginas iniciales de
+    // cada proceso que mapean una biblioteca común (0 = ninguna) y fracción de los
+    // accesos sintéticos que son escrituras (la primera sobre una página compartida la copia)
+    double probabilidad_fork = 0.0;
+    int paginas_biblioteca = 0;
+    double fraccion_escrituras = 0.0;
+
+    // Fusión de páginas iguales (como KSM, requiere el modo contenido): páginas que revisa
+    // el escáner en cada despertar (0 = inactivo) y segundos simulados entre despertares
+    int paginas_ksm = 0;
+    double intervalo_ksm = 0.1;
+
+    // Paginación por demanda: cada página se crea en su primer acceso en vez de al crear
+    // el proceso, y la admisión ya no reserva marcos (sobrecompromiso)
+    bool paginacion_demanda = false;
+
+    // Páginas enormes: una región completa y alineada del proceso se mapea en un bloque
+    // alineado de marcos con una sola entrada de TLB. El promotor (como khugepaged) revisa
+    // regiones_promocion regiones cada intervalo_promocion segundos simulados.
+    bool paginas_enormes = false;
+    int regiones_promocion = 64;
+    double intervalo_promocion = 0.1;
+
+    // Control de carga por conjunto de trabajo (como el de Denning): cada proceso mide las
+    // páginas distintas de sus últimas ventana_trabajo referencias (0 = sin medición) y
+    // cada intervalo_control segundos simulados se compara la suma con la RAM. Con
+    // control_carga, si no cabe se suspenden procesos y las llegadas esperan; sin él solo
+    // se mide. costo_swap_us es lo que tarda leer o escribir una página en SWAP (para el
+    // rendimiento estimado).
+    int ventana_trabajo = 0;
+    bool control_carga = true;
+    double intervalo_control = 0.1;
+    double costo_swap_us = 5000.0;
+
+    // Memoria virtual = física × factor_virtual (0 = al azar entre 1.5 y 4.5, como el original)
+    double factor_virtual = 0.0;
+
+    // Barrido de parámetros: especificación, hilos (0 = todos los núcleos) y archivo de resultados
+    string archivo_barrido;
+    int hilos = 0;
+    string archivo_resultados;
+
+    // Estado guardado: archivo donde se guarda el estado completo al terminar y archivo
+    // desde el que se continúa una simulación (sus opciones pasan a ser las de partida)
+    string archivo_guardar_estado;
+    string archivo_restaurar_estado;
+
+    // Modo concurrente: un hilo por grupo de procesos (--hilos) y accesos de cada proceso
+    bool modo_concurrente = false;
+    long long accesos_por_proceso = 1000000;
+
+    // TLB: entradas (0 = sin TLB), vías por conjunto, etiquetas con ASID o vaciado en
+    // cada cambio de proceso, y reemplazo dentro del conjunto ("lru" o "fifo")
+    int tlb_entradas = 0;
+    int tlb_vias = 4;
+    bool tlb_asid = true;
+    string tlb_reemplazo = "lru";
+};
+
+// Resultado de una simulación, para agregar muchas ejecuciones en una tabla
+struct ResultadoSimulacion {
+    int marcos_ram = 0;
+    int marcos_swap = 0;
+    double memoria_virtual_mb = 0.0;
+    unsigned long long procesos_creados = 0;
+    unsigned long long procesos_finalizados = 0;
+    unsigned long long accesos = 0;
+    unsigned long long fallos_pagina = 0;
+    unsigned long long paginas_creadas = 0;
+    unsigned long long eventos_procesados = 0;
+    double tiempo_simulado = 0.0;
+    double tiempo_real = 0.0;   // Segundos reales que tomó la simulación
+    unsigned long long tlb_aciertos = 0;
+    unsigned long long tlb_fallos = 0;
+    unsigned long long tlb_derribos = 0;
+    unsigned long long expulsiones = 0;
+    unsigned long long anticipadas = 0;             // Páginas traídas por lectura anticipada
+    unsigned long long aciertos_anticipados = 0;    // ... que se usaron antes de salir de RAM
+    unsigned long long anticipadas_sin_uso = 0;     // ... expulsadas o liberadas sin usarse
+    unsigned long long expulsiones_anticipacion = 0; // Expulsiones para hacer lugar a anticipadas
+    unsigned long long expulsiones_fondo = 0;       // Expulsiones del reclamador en segundo plano
+    unsigned long long recuperacion_directa = 0;    // Fallos que tuvieron que expulsar ellos mismos
+    unsigned long long zswap_aciertos = 0;          // Swap-in servidos por la caché comprimida
+    unsigned long long zswap_devueltas = 0;         // Páginas que la caché devolvió al archivo
+    double razon_compresion = 0.0;                  // Bytes originales / comprimidos de la caché
+    unsigned long long forks = 0;                   // Procesos creados como fork de otro
+    unsigned long long copias_escritura = 0;        // Páginas compartidas copiadas al escribirlas
+    unsigned long long fusiones_ksm = 0;            // Páginas iguales fusionadas por el escáner
+    unsigned long long compartidas_pico = 0;        // Máximo de marcos ahorrados por compartir
+    unsigned long long fallos_demanda = 0;          // Páginas creadas en su primer acceso
+    unsigned long long enormes_mapeadas = 0;        // Regiones mapeadas como página enorme al crearse
+    unsigned long long enormes_promovidas = 0;      // Regiones promovidas a página enorme
+    unsigned long long enormes_divididas = 0;       // Páginas enormes divididas en páginas base
+    unsigned long long nodos_tabla_pico = 0;        // Máximo de nodos de tablas radix vivos
+    unsigned long long demanda_pico = 0;            // Máxima suma de conjuntos de trabajo (marcos)
+    unsigned long long sobrecargas = 0;             // Revisiones en que la suma no cabía en RAM
+    unsigned long long suspensiones = 0;            // Procesos suspendidos por el control de carga
+    unsigned long long reanudaciones = 0;           // Procesos suspendidos que volvieron a correr
+    unsigned long long llegadas_diferidas = 0;      // Llegadas que esperaron lugar en RAM
+    double rendimiento = 0.0;                       // Accesos por segundo estimados
+};
+
+// Lee un tamaño en bytes con sufijo opcional K, M, G o T (potencias de 1024, también
+// KB, MB, ...; B = bytes). Sin sufijo el número son MB, como cuando los tamaños eran
+// enteros en MB. Retorna false si el texto no es un tamaño.
+bool leerTamano(const string& texto, uint64_t& bytes) {
+    char* fin = nullptr;
+    double valor = strtod(texto.c_str(), &fin);
+    if (fin == texto.c_str() || valor < 0) return false;
+    string sufijo(fin);
+    for (char& c : sufijo) c = toupper(static_cast<unsigned char>(c));
+    double unidad;
+    if (sufijo.empty() || sufijo == "M" || sufijo == "MB") unidad = 1 << 20;
+    else if (sufijo == "B") unidad = 1;
+    else if (sufijo == "K" || sufijo == "KB") unidad = 1 << 10;
+    else if (sufijo == "G" || sufijo == "GB") unidad = 1 << 30;
+    else if (sufijo == "T" || sufijo == "TB") unidad = 1ULL << 40;
+    else return false;
+    if (valor * unidad >= 18446744073709551615.0) return false;
+    bytes = static_cast<uint64_t>(valor * unidad);
+    return true;
+}
+
+// Número real completo (sin texto sobrante); retorna false si no lo es
+bool leerReal(const string& texto, double& valor) {
+    char* fin = nullptr;
+    double leido = strtod(texto.c_str(), &fin);
+    if (fin == texto.c_str() || *fin != '\0' || !isfinite(leido)) return false;
+    valor = leido;
+    return true;
+}
+
+// Entero decimal completo que cabe en el tipo del destino; retorna false si no lo es
+template <class Entero>
+bool leerEntero(const string& texto, Entero& valor) {
+    char* fin = nullptr;
+    errno = 0;
+    long long leido = strtoll(texto.c_str(), &fin, 10);
+    if (fin == texto.c_str() || *fin != '\0' || errno == ERANGE ||
+        leido < static_cast<long long>(numeric_limits<Entero>::min()) ||
+        leido > static_cast<long long>(numeric_limits<Entero>::max())) {
+        return false;
+    }
+    valor = static_cast<Entero>(leido);
+    return true;
+}
+
+// "si" o "no"
+bool leerSiNo(const string& texto, bool& valor) {
+    if (texto != "si" && texto != "no") return false;
+    valor = (texto == "si");
+    return true;
+}
+
+// Tamaño para mostrar: en MB si es un número exacto de MB (como antes), si no en KB o bytes
+string textoTamano(uint64_t bytes) {
+    if (bytes % (1 << 20) == 0) return to_string(bytes >> 20) + " MB";
+    if (bytes % (1 << 10) == 0) return to_string(bytes >> 10) + " KB";
+    return to_string(bytes) + " bytes";
+}
+
+// Entero uniforme en [minimo, maximo]. Si el rango cabe en int se sortea con la
+// distribución de 32 bits, así las simulaciones con tamaños pequeños repiten la misma
+// secuencia que cuando las páginas eran int.
+inline int64_t enteroUniforme(int64_t minimo, int64_t maximo, mt19937& generador) {
+    if (minimo >= numeric_limits<int>::min() && maximo <= numeric_limits<int>::max()) {
+        return uniform_int_distribution<int>(static_cast<int>(minimo), static_cast<int>(maximo))(generador);
+    }
+    return uniform_int_distribution<int64_t>(minimo, maximo)(generador);
+}
+
+// Tamaño al azar de un proceso entre el mínimo y el máximo. Si ambos son MB exactos se
+// sortea en MB (la secuencia de siempre); si no, en páginas.
+uint64_t sortearTamanoProceso(const ConfiguracionSimulacion& config, mt19937& generador) {
+    const uint64_t MB = 1 << 20;
+    uint64_t unidad = (config.proceso_min % MB == 0 && config.proceso_max % MB == 0) ? MB : config.tamano_pagina;
+    int64_t minimo = (config.proceso_min + unidad - 1) / unidad;
+    int64_t maximo = max<int64_t>(minimo, config.proceso_max / unidad);
+    return enteroUniforme(minimo, maximo, generador) * unidad;
+}
+
 // ============================================================================
-// ESTRUCTURAS DE DATOS
+// GENERADOR DE CARGA SINTÉTICA
 // ============================================================================
 
-// Estructura que representa una página de memoria
-struct Pagina {
-    int pid;                    // ID del proceso dueño de esta página
-    int id_pagina;              // ID local de la página dentro del proceso (0, 1, 2...)
-    int id_global;              // ID global único de la página
-    bool en_ram;                // True si la página está actualmente en RAM
-    int indice_marco;           // Índice del marco en RAM (-1 si no está en RAM)
-    int indice_swap;            // Índice del marco en SWAP (-1 si no está en SWAP)
-    unsigned long long tiempo_carga; // Tiempo de carga (para política FIFO)
-    
-    // Constructor de la página
-    Pagina(int p_pid, int p_id_pagina, int p_id_global): 
-        pid(p_pid), 
-        id_pagina(p_id_pagina),
-        id_global(p_id_global),
-        en_ram(false), 
-        indice_marco(-1), 
-        indice_swap(-1), 
-        tiempo_carga(0) {}
+// Estado del modelo de acceso de un proceso. Vive dentro del proceso y guarda un lote
+// de páginas ya generadas, así que generar accesos no reserva memoria.
+struct EstadoCarga {
+    static const int TAMANO_LOTE = 32;
+    int64_t lote[TAMANO_LOTE];  // Páginas locales generadas y aún no accedidas
+    int posicion_lote = 0;      // Próxima página del lote
+    int tamano_lote = 0;        // Páginas válidas en el lote
+    int64_t cursor = 0;         // Posición del recorrido secuencial
+    int64_t base_ventana = 0;   // Inicio del conjunto de trabajo
+    unsigned int accesos = 0;   // Accesos generados (para deriva y fases)
+    int64_t desplazamiento = 0; // Rotación del conjunto caliente de Zipf (distinto por proceso)
+    double zipf_h_x1 = 0;       // Constantes del muestreo Zipf por rechazo-inversión
+    double zipf_h_n = 0;
+    double zipf_s = 0;
+};
+
+// Genera los accesos de cada proceso según el modelo configurado. Zipf usa el método de
+// rechazo-inversión de Hörmann y Derflinger: O(1) esperado por muestra y sin tablas.
+class GeneradorCarga {
+private:
+    ModeloCarga modelo;
+    double exponente;
+    double fraccion_ventana;
+    unsigned int accesos_por_deriva;
+    unsigned int accesos_por_fase;
+
+    // Funciones auxiliares de rechazo-inversión (estables cuando el argumento tiende a 0)
+    static double auxiliar1(double x) {
+        return fabs(x) > 1e-8 ? log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+    static double auxiliar2(double x) {
+        return fabs(x) > 1e-8 ? expm1(x) / x : 1 + x * 0.5 * (1 + x / 3.0 * (1 + 0.25 * x));
+    }
+    double h(double x) const { return exp(-exponente * log(x)); }
+    double integralH(double x) const {
+        double log_x = log(x);
+        return auxiliar2((1 - exponente) * log_x) * log_x;
+    }
+    double inversaIntegralH(double x) const {
+        double t = x * (1 - exponente);
+        if (t < -1) t = -1;
+        return exp(auxiliar1(t) * x);
+    }
+
+    // Rango Zipf en [0, num_paginas) (0 = página más popular)
+    int64_t muestraZipf(EstadoCarga& estado, int64_t num_paginas, mt19937& generador) const {
+        uniform_real_distribution<double> uniforme(0.0, 1.0);
+        while (true) {
+            double u = estado.zipf_h_n + uniforme(generador) * (estado.zipf_h_x1 - estado.zipf_h_n);
+            double x = inversaIntegralH(u);
+            int64_t k = static_cast<int64_t>(x + 0.5);
+            if (k < 1) k = 1;
+            else if (k > num_paginas) k = num_paginas;
+            if (k - x <= estado.zipf_s || u >= integralH(k + 0.5) - h(k)) return k - 1;
+        }
+    }
+
+    // Página según un modelo concreto (MIXTA se resuelve antes en fases)
+    int64_t generar(ModeloCarga actual, EstadoCarga& estado, int64_t num_paginas, mt19937& generador) const {
+        switch (actual) {
+            case ModeloCarga::ZIPF:
+                return (muestraZipf(estado, num_paginas, generador) + estado.desplazamiento) % num_paginas;
+            case ModeloCarga::CONJUNTO: {
+                int64_t ventana = max<int64_t>(1, static_cast<int64_t>(num_paginas * fraccion_ventana));
+                if (estado.accesos % accesos_por_deriva == 0) {
+                    estado.base_ventana = (estado.base_ventana + 1) % num_paginas; // El conjunto se desplaza
+                }
+                return (estado.base_ventana + enteroUniforme(0, ventana - 1, generador)) % num_paginas;
+            }
+            case ModeloCarga::SECUENCIAL: {
+                int64_t pagina = estado.cursor;
+                estado.cursor = (estado.cursor + 1) % num_paginas;
+                return pagina;
+            }
+            default:
+                return enteroUniforme(0, num_paginas - 1, generador);
+        }
+    }
+
+public:
+    explicit GeneradorCarga(const ConfiguracionSimulacion& config)
+        : modelo(config.modelo_carga),
+          exponente(config.zipf_exponente),
+          fraccion_ventana(config.fraccion_ventana),
+          accesos_por_deriva(max(1, config.accesos_por_deriva)),
+          accesos_por_fase(max(1, config.accesos_por_fase)) {}
+
+    ModeloCarga obtenerModelo() const { return modelo; }
+
+    // Prepara el estado de un proceso nuevo (solo usa el generador si el modelo lo necesita)
+    void inicializarEstado(EstadoCarga& estado, int64_t num_paginas, mt19937& generador) const {
+        estado = EstadoCarga();
+        if (modelo == ModeloCarga::ZIPF || modelo == ModeloCarga::MIXTA) {
+            estado.zipf_h_x1 = integralH(1.5) - 1.0;
+            estado.zipf_h_n = integralH(num_paginas + 0.5);
+            estado.zipf_s = 2.0 - inversaIntegralH(integralH(2.5) - h(2.0));
+            estado.desplazamiento = enteroUniforme(0, num_paginas - 1, generador);
+        }
+    }
+
+    // Rellena el lote del proceso con las próximas páginas a acceder
+    void generarLote(EstadoCarga& estado, int64_t num_paginas, mt19937& generador) const {
+        for (int i = 0; i < EstadoCarga::TAMANO_LOTE; ++i) {
+            ModeloCarga actual = modelo;
+            if (modelo == ModeloCarga::MIXTA) {
+                static const ModeloCarga fases[3] = {ModeloCarga::SECUENCIAL, ModeloCarga::ZIPF, ModeloCarga::CONJUNTO};
+                actual = fases[(estado.accesos / accesos_por_fase) % 3];
+            }
+            estado.lote[i] = generar(actual, estado, num_paginas, generador);
+            estado.accesos++;
+        }
+        estado.posicion_lote = 0;
+        estado.tamano_lote = EstadoCarga::TAMANO_LOTE;
+    }
+
+    // Próxima página local que accederá el proceso
+    int64_t siguientePagina(EstadoCarga& estado, int64_t num_paginas, mt19937& generador) const {
+        if (estado.posicion_lote == estado.tamano_lote) generarLote(estado, num_paginas, generador);
+        return estado.lote[estado.posicion_lote++];
+    }
+};
+
+// Convierte el nombre de un modelo de carga; retorna false si no existe
+bool leerModeloCarga(const string& nombre, ModeloCarga& modelo) {
+    if (nombre == "forzado") modelo = ModeloCarga::FORZADO;
+    else if (nombre == "uniforme") modelo = ModeloCarga::UNIFORME;
+    else if (nombre == "zipf") modelo = ModeloCarga::ZIPF;
+    else if (nombre == "conjunto") modelo = ModeloCarga::CONJUNTO;
+    else if (nombre == "secuencial") modelo = ModeloCarga::SECUENCIAL;
+    else if (nombre == "mixta") modelo = ModeloCarga::MIXTA;
+    else return false;
+    return true;
+}
+
+// Nombre de un modelo de carga (el mismo que acepta --carga)
+const char* nombreModeloCarga(ModeloCarga modelo) {
+    switch (modelo) {
+        case ModeloCarga::FORZADO:    return "forzado";
+        case ModeloCarga::UNIFORME:   return "uniforme";
+        case ModeloCarga::ZIPF:       return "zipf";
+        case ModeloCarga::CONJUNTO:   return "conjunto";
+        case ModeloCarga::SECUENCIAL: return "secuencial";
+        case ModeloCarga::MIXTA:      return "mixta";
+    }
+    return "desconocido";
+}
+
+// ============================================================================
+// TABLA DE PÁGINAS MULTINIVEL (RADIX POR PROCESO)
+// ============================================================================
+
+// Tabla de páginas de un proceso como árbol radix de nodos de 512 entradas, igual que
+// las tablas de x86-64: cada nivel resuelve 9 bits de la página virtual. Las hojas
+// guardan la ranura de la página en la tabla global (-1 = sin mapear) y los nodos
+// interiores el índice de su hijo (-1 = sin crear). Los nodos se crean al mapear la
+// primera página que cae bajo ellos, así un espacio de direcciones disperso solo paga
+// por las regiones que usa. Todos los nodos viven en un arreglo por proceso (se
+// liberan juntos al finalizarlo). Cada hoja cubre una región del tamaño de una página
+// enorme y lleva una marca si la región está mapeada como página enorme.
+class TablaRadix {
+public:
+    static constexpr int ENTRADAS = PAGINAS_ENORME;
+
+private:
+    vector<int> entradas;       // Nodos de ENTRADAS enteros seguidos; el 0 es la raíz
+    vector<uint8_t> enormes;    // Por nodo: 1 si es una hoja mapeada como página enorme
+    int niveles;                // Niveles del árbol (1 = la raíz es la única hoja)
+
+    int crearNodo() {
+        int nodo = enormes.size();
+        entradas.resize(entradas.size() + ENTRADAS, -1);
+        enormes.push_back(0);
+        return nodo;
+    }
+
+    // Hoja que cubre la página (-1 si aún no existe)
+    int hoja(int64_t pagina) const {
+        int nodo = 0;
+        for (int nivel = niveles - 1; nivel > 0 && nodo != -1; --nivel) {
+            nodo = entradas[size_t(nodo) * ENTRADAS + ((pagina >> (BITS_ENORME * nivel)) & (ENTRADAS - 1))];
+        }
+        return nodo;
+    }
+
+    // Hoja que cubre la página, creando los nodos que falten en el camino
+    int crearHoja(int64_t pagina) {
+        int nodo = 0;
+        for (int nivel = niveles - 1; nivel > 0; --nivel) {
+            size_t entrada = size_t(nodo) * ENTRADAS + ((pagina >> (BITS_ENORME * nivel)) & (ENTRADAS - 1));
+            if (entradas[entrada] == -1) {
+                int hijo = crearNodo();
+                entradas[entrada] = hijo;
+            }
+            nodo = entradas[entrada];
+        }
+        return nodo;
+    }
+
+    template <class Funcion>
+    bool recorrerNodo(int nodo, int nivel, int64_t prefijo, Funcion& funcion) const {
+        for (int i = 0; i < ENTRADAS; ++i) {
+            int valor = entradas[size_t(nodo) * ENTRADAS + i];
+            if (valor == -1) continue;
+            int64_t indice = (prefijo << BITS_ENORME) | i;
+            if (nivel == 0 ? !funcion(indice, valor) : !recorrerNodo(valor, nivel - 1, indice, funcion)) return false;
+        }
+        return true;
+    }
+
+    // Primera región >= desde con hoja bajo el nodo (nivel >= 1), -1 si no hay
+    int64_t regionNodo(int nodo, int nivel, int64_t prefijo, int64_t desde) const {
+        for (int i = 0; i < ENTRADAS; ++i) {
+            int hijo = entradas[size_t(nodo) * ENTRADAS + i];
+            int64_t indice = (prefijo << BITS_ENORME) | i;
+            if (hijo == -1 || ((indice + 1) << (BITS_ENORME * (nivel - 1))) <= desde) continue;
+            int64_t region = nivel == 1 ? indice : regionNodo(hijo, nivel - 1, indice, desde);
+            if (region != -1) return region;
+        }
+        return -1;
+    }
+
+public:
+    TablaRadix() : niveles(0) {}
+
+    // Tabla vacía (solo la raíz) con niveles suficientes para num_paginas
+    void inicializar(int64_t num_paginas) {
+        niveles = 1;
+        while (niveles * BITS_ENORME < 63 && (int64_t(1) << (niveles * BITS_ENORME)) < num_paginas) niveles++;
+        entradas.assign(ENTRADAS, -1);
+        enormes.assign(1, 0);
+    }
+
+    // Ranura de la página (-1 si no está mapeada)
+    int buscar(int64_t pagina) const {
+        int nodo = hoja(pagina);
+        return nodo == -1 ? -1 : entradas[size_t(nodo) * ENTRADAS + (pagina & (ENTRADAS - 1))];
+    }
+
+    void mapear(int64_t pagina, int ranura) {
+        int nodo = crearHoja(pagina);
+        entradas[size_t(nodo) * ENTRADAS + (pagina & (ENTRADAS - 1))] = ranura;
+    }
+
+    // Las ENTRADAS ranuras de una región (nullptr si su hoja no existe)
+    const int* region(int64_t region) const {
+        int nodo = hoja(region << BITS_ENORME);
+        return nodo == -1 ? nullptr : &entradas[size_t(nodo) * ENTRADAS];
+    }
+
+    bool enorme(int64_t region) const {
+        int nodo = hoja(region << BITS_ENORME);
+        return nodo != -1 && enormes[nodo];
+    }
+
+    void marcarEnorme(int64_t region, bool enorme) { enormes[crearHoja(region << BITS_ENORME)] = enorme; }
+
+    // Primera región >= desde que tiene hoja (-1 si no hay más)
+    int64_t siguienteRegion(int64_t desde) const {
+        if (niveles == 1) return desde <= 0 ? 0 : -1;
+        return regionNodo(0, niveles - 1, 0, desde);
+    }
+
+    // Llama a funcion(pagina, ranura) por cada página mapeada, en orden de página;
+    // si la función retorna false el recorrido se detiene
+    template <class Funcion>
+    void recorrer(Funcion funcion) const {
+        if (niveles > 0) recorrerNodo(0, niveles - 1, 0, funcion);
+    }
+
+    // Suelta todos los nodos (fin del proceso)
+    void liberar() {
+        vector<int>().swap(entradas);
+        vector<uint8_t>().swap(enormes);
+        niveles = 0;
+    }
+
+    size_t numNodos() const { return enormes.size(); }
+    size_t bytes() const { return entradas.capacity() * sizeof(int) + enormes.capacity(); }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.arreglo(entradas);
+        archivo.arreglo(enormes);
+        archivo.valor(niveles);
+    }
 };
 
+// ============================================================================
+// ESTRUCTURAS DE DATOS
+// ============================================================================
+
 // Estructura que representa un proceso
 struct Proceso {
     int pid;                   // ID único del proceso
-    int tamano_mb;             // Tamaño total del proceso en MB
-    int num_paginas;           // Número de páginas que ocupa el proceso
+    uint64_t tamano;           // Tamaño total del proceso en bytes
+    int64_t num_paginas;       // Número de páginas de su espacio virtual
     bool activo;               // Si el proceso está activo (no finalizado)
-    vector<int> indices_paginas; // Índices de las páginas en el vector global 'paginas'
+    int posicion_activa;       // Posición en la lista de procesos activos del simulador
+    int64_t paginas_mapeadas;  // Páginas creadas (todas, salvo con paginación por demanda)
+    int paginas_residentes;    // Páginas en RAM (el resto de las mapeadas está en SWAP)
+    int ventana_anticipacion;  // Páginas de la última lectura anticipada (con la del fallo)
+    int aciertos_anticipacion; // Páginas anticipadas usadas desde esa lectura
+    int64_t ultimo_fallo;      // Página local del último fallo (para detectar recorridos)
+    int64_t tiempo_virtual;    // Referencias hechas (reloj del conjunto de trabajo)
+    int conjunto_trabajo;      // Páginas distintas entre sus últimas referencias
+    vector<int> referencias_recientes; // Anillo con la ranura de sus últimas referencias
+    TablaRadix tabla;          // Página virtual -> ranura en la tabla global 'paginas'
+    EstadoCarga carga;         // Estado de su modelo de acceso
     
     // Constructor del proceso
-    Proceso(int p_pid, int p_tamano_mb, int p_num_paginas): 
+    Proceso(int p_pid, uint64_t p_tamano, int64_t p_num_paginas): 
         pid(p_pid), 
-        tamano_mb(p_tamano_mb), 
+        tamano(p_tamano), 
         num_paginas(p_num_paginas), 
-        activo(true) {}
+        activo(true),
+        posicion_activa(-1),
+        paginas_mapeadas(0),
+        paginas_residentes(0),
+        ventana_anticipacion(0),
+        aciertos_anticipacion(0),
+        ultimo_fallo(-2),
+        tiempo_virtual(0),
+        conjunto_trabajo(0) {
+        tabla.inicializar(num_paginas);
+    }
+
+    // Proceso vacío, para llenarlo al restaurar un estado guardado
+    Proceso() : Proceso(0, 0, 0) {}
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.valor(pid);
+        archivo.valor(tamano);
+        archivo.valor(num_paginas);
+        archivo.valor(activo);
+        archivo.valor(posicion_activa);
+        archivo.valor(paginas_mapeadas);
+        archivo.valor(paginas_residentes);
+        archivo.valor(ventana_anticipacion);
+        archivo.valor(aciertos_anticipacion);
+        archivo.valor(ultimo_fallo);
+        archivo.valor(tiempo_virtual);
+        archivo.valor(conjunto_trabajo);
+        archivo.arreglo(referencias_recientes);
+        tabla.serializar(archivo);
+        archivo.valor(carga);
+    }
+};
+
+// Tipos de eventos del simulador de eventos discretos
+enum class TipoEvento {
+    LLEGADA_PROCESO,            // Llega (se crea) un nuevo proceso
+    FINALIZACION_PROCESO,       // Termina un proceso aleatorio
+    ACCESO_MEMORIA,             // Un proceso accede a una dirección virtual
+    INSTANTANEA_METRICAS,       // Se escriben las métricas (solo si están activas)
+    RECUPERACION_FONDO,         // Despierta el reclamador en segundo plano
+    ESCANEO_KSM,                // Despierta el escáner de fusión de páginas iguales
+    PROMOCION_ENORMES,          // Despierta el promotor de páginas enormes
+    CONTROL_CARGA               // Revisa los conjuntos de trabajo contra la RAM
+};
+
+// Evento con marca de tiempo simulado
+struct Evento {
+    double tiempo;                   // Instante simulado en segundos
+    unsigned long long secuencia;    // Orden de programación (desempate determinista)
+    TipoEvento tipo;                 // Qué ocurre en este instante
+
+    // Orden para la cola de prioridad: primero el menor tiempo, luego el programado antes
+    bool operator>(const Evento& otro) const {
+        if (tiempo != otro.tiempo) return tiempo > otro.tiempo;
+        return secuencia > otro.secuencia;
+    }
 };
 
 // ============================================================================
-// CLASE PRINCIPAL - SIMULADOR DE MEMORIA
+// ASIGNADOR DE MARCOS (RAM y SWAP)
 // ============================================================================
 
-class SimuladorMemoria {
+// Asignador de marcos libres con mapa de bits jerárquico.
+// El nivel 0 tiene un bit por marco (1 = libre); cada bit del nivel k indica si la
+// palabra correspondiente del nivel k-1 tiene algún marco libre. Buscar el primer
+// marco libre baja un nivel por vez con find-first-set, así que asignar y liberar
+// cuestan O(log64 n) (a lo más 4 niveles para 16M marcos) y siempre entregan el marco
+// libre de menor índice, igual que la búsqueda lineal anterior.
+//
+// Con bloques activos también lleva la cuenta de libres de cada bloque alineado de
+// PAGINAS_ENORME marcos, con dos mapas jerárquicos más: bloques completamente libres
+// (para páginas enormes) y bloques parcialmente usados. Como el buddy allocator, un
+// marco suelto se toma de un bloque ya partido mientras haya, y solo se parte un bloque
+// libre cuando no queda otro.
+class AsignadorMarcos {
 private:
-    // Configuración del sistema
-    int memoria_fisica_mb;      // Tamaño de la memoria física en MB
-    int tamano_pagina_mb;       // Tamaño de cada página en MB
-    int proceso_min_mb;         // Tamaño mínimo de proceso en MB
-    int proceso_max_mb;         // Tamaño máximo de proceso en MB
-    
-    // Representación de la memoria
-    vector<int> marcos_ram;     // Vector de marcos de RAM: -1 = libre, índice = página
-    vector<int> marcos_swap;    // Vector de marcos de SWAP: -1 = libre, índice = página
+    typedef vector<vector<uint64_t>> MapaBits;
+
+    vector<int> ocupantes;              // Página en cada marco (-1 = libre)
+    MapaBits niveles;                   // Mapa de bits jerárquico de marcos libres
+    size_t num_libres;                  // Marcos libres, mantenido incrementalmente
+    vector<uint16_t> libres_bloque;     // Marcos libres de cada bloque completo (vacío = sin bloques)
+    MapaBits bloques_libres;            // Bloques con todos sus marcos libres
+    MapaBits bloques_partidos;          // Bloques con algunos marcos libres y otros usados
+
+    // Mapa de 'bits' bits, todos en 1 (o todos en 0)
+    static void construirMapa(MapaBits& mapa, size_t bits, bool llenos) {
+        mapa.clear();
+        do {
+            size_t palabras = (bits + 63) / 64;
+            vector<uint64_t> nivel(palabras, llenos ? ~0ULL : 0);
+            if (llenos && bits % 64 != 0) nivel.back() = (1ULL << (bits % 64)) - 1; // Sin bits fuera de rango
+            mapa.push_back(nivel);
+            bits = palabras;
+        } while (bits > 1);
+    }
+
+    // Enciende o apaga un bit y propaga el cambio a los niveles superiores
+    static void actualizarMapa(MapaBits& mapa, size_t indice, bool libre) {
+        for (auto& nivel : mapa) {
+            uint64_t& palabra = nivel[indice / 64];
+            bool estaba_vacia = (palabra == 0);
+            if (libre) palabra |= (1ULL << (indice % 64));
+            else palabra &= ~(1ULL << (indice % 64));
+            // Solo hay que subir si la palabra cambió entre "vacía" y "con libres"
+            if (estaba_vacia == (palabra == 0)) break;
+            indice /= 64;
+        }
+    }
+
+    // Primer bit encendido del mapa (el mapa no debe estar vacío)
+    static size_t primerBit(const MapaBits& mapa) {
+        size_t indice = 0;
+        for (size_t k = mapa.size(); k-- > 0;) {
+            indice = indice * 64 + __builtin_ctzll(mapa[k][indice]);
+        }
+        return indice;
+    }
+
+    // Marca el marco como libre u ocupado y actualiza la cuenta de su bloque
+    void actualizarBit(size_t marco, bool libre) {
+        actualizarMapa(niveles, marco, libre);
+        size_t bloque = marco / PAGINAS_ENORME;
+        if (bloque >= libres_bloque.size()) return; // Sin bloques o bloque incompleto del final
+        int antes = libres_bloque[bloque];
+        int despues = antes + (libre ? 1 : -1);
+        libres_bloque[bloque] = despues;
+        if ((antes == PAGINAS_ENORME) != (despues == PAGINAS_ENORME)) {
+            actualizarMapa(bloques_libres, bloque, despues == PAGINAS_ENORME);
+        }
+        bool partido_antes = antes > 0 && antes < PAGINAS_ENORME;
+        bool partido = despues > 0 && despues < PAGINAS_ENORME;
+        if (partido_antes != partido) actualizarMapa(bloques_partidos, bloque, partido);
+    }
+
+    static bool mapaVacio(const MapaBits& mapa) { return mapa.empty() || mapa.back()[0] == 0; }
+
+    template <class Archivo>
+    static void serializarMapa(Archivo& archivo, MapaBits& mapa) {
+        mapa.resize(archivo.cantidad(mapa.size()));
+        for (vector<uint64_t>& nivel : mapa) archivo.arreglo(nivel);
+    }
+
+public:
+    AsignadorMarcos() : num_libres(0) {}
+
+    // Crea 'total' marcos, todos libres; con bloques, también lleva los bloques alineados
+    void inicializar(size_t total, bool con_bloques = false) {
+        ocupantes.assign(total, -1);
+        construirMapa(niveles, total, true);
+        num_libres = total;
+        size_t num_bloques = con_bloques ? total / PAGINAS_ENORME : 0;
+        libres_bloque.assign(num_bloques, PAGINAS_ENORME);
+        bloques_libres.clear();
+        bloques_partidos.clear();
+        if (num_bloques > 0) {
+            construirMapa(bloques_libres, num_bloques, true);
+            construirMapa(bloques_partidos, num_bloques, false);
+        }
+    }
+
+    // Asigna un marco libre a la página indicada (-1 si no hay): el de menor índice, o
+    // con bloques, el de menor índice del primer bloque partido si hay alguno
+    int asignar(int pagina) {
+        if (num_libres == 0) return -1;
+        size_t indice;
+        if (mapaVacio(bloques_partidos)) {
+            indice = primerBit(niveles);
+        } else {
+            size_t palabra = primerBit(bloques_partidos) * (PAGINAS_ENORME / 64);
+            while (niveles[0][palabra] == 0) palabra++;
+            indice = palabra * 64 + __builtin_ctzll(niveles[0][palabra]);
+        }
+        ocupantes[indice] = pagina;
+        actualizarBit(indice, false);
+        num_libres--;
+        return indice;
+    }
+
+    // Hay un bloque alineado de PAGINAS_ENORME marcos libres (requiere bloques)
+    bool hayBloqueLibre() const { return !mapaVacio(bloques_libres); }
+
+    // Asigna el primer bloque libre a las PAGINAS_ENORME páginas indicadas y retorna su
+    // primer marco (-1 si no hay bloque libre)
+    int asignarBloque(const int* paginas) {
+        if (!hayBloqueLibre()) return -1;
+        size_t primero = primerBit(bloques_libres) * PAGINAS_ENORME;
+        for (int i = 0; i < PAGINAS_ENORME; ++i) {
+            ocupantes[primero + i] = paginas[i];
+            actualizarBit(primero + i, false);
+        }
+        num_libres -= PAGINAS_ENORME;
+        return primero;
+    }
+
+    // Libera un marco ocupado
+    void liberar(int marco) {
+        if (ocupantes[marco] == -1) return;
+        ocupantes[marco] = -1;
+        actualizarBit(marco, true);
+        num_libres++;
+    }
+
+    // Cambia la página que ocupa un marco ya asignado
+    void reasignar(int marco, int pagina) { ocupantes[marco] = pagina; }
+
+    int ocupante(int marco) const { return ocupantes[marco]; }
+    size_t libres() const { return num_libres; }
+    size_t usados() const { return ocupantes.size() - num_libres; }
+    size_t total() const { return ocupantes.size(); }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.arreglo(ocupantes);
+        serializarMapa(archivo, niveles);
+        archivo.valor(num_libres);
+        archivo.arreglo(libres_bloque);
+        serializarMapa(archivo, bloques_libres);
+        serializarMapa(archivo, bloques_partidos);
+    }
+};
+
+// ============================================================================
+// LISTA INTRUSIVA DE MARCOS
+// ============================================================================
+
+// Lista doblemente enlazada intrusiva sobre índices de marco.
+// Los enlaces viven en vectores indexados por marco, así que insertar al final,
+// quitar desde cualquier posición (por ejemplo al finalizar un proceso) y leer el
+// frente cuestan O(1) sin reservar memoria por operación.
+class ListaMarcos {
+private:
+    vector<int> siguiente;      // Marco siguiente en la lista (-1 = ninguno)
+    vector<int> anterior;       // Marco anterior en la lista (-1 = ninguno)
+    vector<char> en_lista;      // 1 si el marco pertenece a la lista
+    int cabeza;                 // Primer marco (el más antiguo)
+    int cola;                   // Último marco (el más reciente)
+    size_t tamano;              // Marcos en la lista
+
+public:
+    ListaMarcos() : cabeza(-1), cola(-1), tamano(0) {}
+
+    // Prepara la lista para 'num_marcos' marcos, vacía
+    void inicializar(size_t num_marcos) {
+        siguiente.assign(num_marcos, -1);
+        anterior.assign(num_marcos, -1);
+        en_lista.assign(num_marcos, 0);
+        cabeza = cola = -1;
+        tamano = 0;
+    }
+
+    // Agrega un marco al final
+    void insertar(int marco) {
+        anterior[marco] = cola;
+        siguiente[marco] = -1;
+        if (cola != -1) siguiente[cola] = marco;
+        else cabeza = marco;
+        cola = marco;
+        en_lista[marco] = 1;
+        tamano++;
+    }
+
+    // Quita un marco desde cualquier posición
+    void quitar(int marco) {
+        if (!en_lista[marco]) return;
+        if (anterior[marco] != -1) siguiente[anterior[marco]] = siguiente[marco];
+        else cabeza = siguiente[marco];
+        if (siguiente[marco] != -1) anterior[siguiente[marco]] = anterior[marco];
+        else cola = anterior[marco];
+        en_lista[marco] = 0;
+        tamano--;
+    }
+
+    // Mueve un marco al final (por ejemplo, al ser referenciado en LRU)
+    void moverAlFinal(int marco) {
+        quitar(marco);
+        insertar(marco);
+    }
+
+    int frente() const { return cabeza; }     // -1 si está vacía
+    // Primer marco distinto de 'excluido' (-1 si no hay)
+    int frenteSin(int excluido) const { return cabeza != -1 && cabeza == excluido ? siguiente[cabeza] : cabeza; }
+    bool contiene(int marco) const { return en_lista[marco]; }
+    size_t size() const { return tamano; }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.arreglo(siguiente);
+        archivo.arreglo(anterior);
+        archivo.arreglo(en_lista);
+        archivo.valor(cabeza);
+        archivo.valor(cola);
+        archivo.valor(tamano);
+    }
+};
+
+// ============================================================================
+// ALMACÉN SLAB DE PÁGINAS Y PROCESOS
+// ============================================================================
+
+// Referencia a una ranura del almacén junto con la generación en que se tomó
+struct ReferenciaSlab {
+    int indice;                 // Ranura dentro del almacén
+    uint32_t generacion;        // Generación de la ranura al crear la referencia
+};
+
+// Almacén tipo slab: las ranuras liberadas se reciclan mediante una lista libre, así
+// que la memoria queda acotada por el máximo de elementos vivos a la vez y no por el
+// total creado. Cada ranura tiene un contador de generación que aumenta al liberarla;
+// una ReferenciaSlab antigua deja de ser válida aunque la ranura se haya reutilizado.
+template <class T>
+class AlmacenSlab {
+private:
+    vector<T> elementos;            // Ranuras (vivas o libres)
+    vector<uint32_t> generaciones;  // Generación actual de cada ranura
+    vector<char> vivos;             // 1 si la ranura tiene un elemento vivo
+    vector<int> libres;             // Pila de ranuras libres para reutilizar
+    size_t num_vivos;               // Elementos vivos
+
+public:
+    AlmacenSlab() : num_vivos(0) {}
+
+    // Guarda un elemento reutilizando una ranura libre si la hay y retorna su índice
+    int crear(T elemento) {
+        int indice;
+        if (!libres.empty()) {
+            indice = libres.back();
+            libres.pop_back();
+            elementos[indice] = move(elemento);
+        } else {
+            indice = elementos.size();
+            elementos.push_back(move(elemento));
+            generaciones.push_back(0);
+            vivos.push_back(0);
+        }
+        vivos[indice] = 1;
+        num_vivos++;
+        return indice;
+    }
+
+    // Libera una ranura; las referencias anteriores quedan obsoletas
+    void liberar(int indice) {
+        if (!vivos[indice]) return;
+        vivos[indice] = 0;
+        generaciones[indice]++;
+        libres.push_back(indice);
+        num_vivos--;
+    }
+
+    ReferenciaSlab referencia(int indice) const { return ReferenciaSlab{indice, generaciones[indice]}; }
+
+    // Retorna el elemento si la referencia sigue vigente, nullptr si es obsoleta
+    T* obtener(ReferenciaSlab ref) {
+        if (ref.indice < 0 || static_cast<size_t>(ref.indice) >= elementos.size()) return nullptr;
+        if (!vivos[ref.indice] || generaciones[ref.indice] != ref.generacion) return nullptr;
+        return &elementos[ref.indice];
+    }
+
+    T& operator[](int indice) { return elementos[indice]; }
+    const T& operator[](int indice) const { return elementos[indice]; }
+    bool vivo(int indice) const { return vivos[indice]; }
+    size_t size() const { return num_vivos; }          // Elementos vivos
+    size_t capacidad() const { return elementos.size(); } // Ranuras reservadas (pico de vivos)
+
+    // Se guardan también las ranuras libres: así las referencias y la lista libre siguen
+    // valiendo tras restaurar
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        elementos.resize(archivo.cantidad(elementos.size()));
+        for (T& elemento : elementos) elemento.serializar(archivo);
+        archivo.arreglo(generaciones);
+        archivo.arreglo(vivos);
+        archivo.arreglo(libres);
+        archivo.valor(num_vivos);
+    }
+};
+
+// ============================================================================
+// TABLA DE PÁGINAS (PTE EMPAQUETADAS, ESTRUCTURA DE ARREGLOS)
+// ============================================================================
+
+// Tabla global de páginas. El estado caliente de cada página es una PTE de 64 bits:
+//
+//   bit 63      presente (la página está en RAM)
+//   bit 62      referenciada
+//   bit 61      sucia (escrita desde que se cargó)
+//   bit 60      válida (la ranura tiene una página viva)
+//   bits 59-36  dueño: ranura del proceso en el almacén de procesos (24 bits)
+//   bit 35      anticipada (traída por lectura anticipada y aún sin usar)
+//   bit 34      compartida (otras páginas usan el mismo marco o ranura; se copia al escribir)
+//   bit 33      enorme (parte de una región mapeada como página enorme)
+//   bits 32-0   ubicación: marco de RAM si está presente, marco de SWAP si no (33 bits)
+//
+// Los datos fríos (página virtual, ID global, ID de contenido, generación) van en arreglos
+// separados, así que recorrer o liberar páginas lee 8 bytes por página en vez de la
+// estructura completa. Las páginas que comparten marco forman un anillo doblemente
+// enlazado (mapa inverso): al expulsar, traer o fusionar ese marco se recorren todas.
+// Las ranuras se reciclan con contador de generación, igual que AlmacenSlab, pero la
+// lista libre es intrusiva: una PTE no válida guarda en su ubicación la siguiente libre.
+class TablaPaginas {
+public:
+    static constexpr uint64_t PTE_PRESENTE     = 1ULL << 63;
+    static constexpr uint64_t PTE_REFERENCIADA = 1ULL << 62;
+    static constexpr uint64_t PTE_SUCIA        = 1ULL << 61;
+    static constexpr uint64_t PTE_VALIDA       = 1ULL << 60;
+    static constexpr uint64_t PTE_ANTICIPADA   = 1ULL << 35;
+    static constexpr uint64_t PTE_COMPARTIDA   = 1ULL << 34;
+    static constexpr uint64_t PTE_ENORME       = 1ULL << 33;
+    static constexpr int      BIT_DUENO        = 36;
+    static constexpr uint64_t MASCARA_DUENO    = (1ULL << 24) - 1;
+    static constexpr uint64_t MASCARA_UBICACION = (1ULL << 33) - 1;
+
+private:
+    vector<uint64_t> ptes;          // Estado caliente, una PTE por ranura
+    vector<int64_t> ids_pagina;     // Página virtual (ID local) dentro de su proceso
+    vector<int64_t> ids_globales;   // ID global (para mostrar)
+    vector<int64_t> ids_contenido;  // Página cuyo contenido inicial tiene (para verificarlo)
+    vector<int> anteriores;         // Anillo de páginas que comparten marco (sí misma si no comparte)
+    vector<int> siguientes;
+    vector<uint32_t> generaciones;  // Generación de cada ranura
+    int primera_libre;              // Cabeza de la lista libre intrusiva (-1 = vacía)
+    size_t num_vivas;               // Páginas vivas
+
+public:
+    TablaPaginas() : primera_libre(-1), num_vivas(0) {}
+
+    // Crea una página fuera de RAM y SWAP; retorna su ranura
+    int crear(int dueno, int64_t id_pagina, int64_t id_global) {
+        int indice;
+        if (primera_libre != -1) {
+            indice = primera_libre;
+            primera_libre = static_cast<int>(ptes[indice] & MASCARA_UBICACION) - 1;
+        } else {
+            indice = ptes.size();
+            ptes.push_back(0);
+            ids_pagina.push_back(0);
+            ids_globales.push_back(0);
+            ids_contenido.push_back(0);
+            anteriores.push_back(0);
+            siguientes.push_back(0);
+            generaciones.push_back(0);
+        }
+        ptes[indice] = PTE_VALIDA | (static_cast<uint64_t>(dueno) << BIT_DUENO);
+        ids_pagina[indice] = id_pagina;
+        ids_globales[indice] = id_global;
+        ids_contenido[indice] = id_global;
+        anteriores[indice] = siguientes[indice] = indice;
+        num_vivas++;
+        return indice;
+    }
+
+    // Libera la ranura; su generación avanza para invalidar referencias antiguas
+    void liberar(int indice) {
+        if (!(ptes[indice] & PTE_VALIDA)) return;
+        ptes[indice] = static_cast<uint64_t>(primera_libre + 1); // 0 = fin de la lista
+        primera_libre = indice;
+        generaciones[indice]++;
+        num_vivas--;
+    }
+
+    // Página presente en el marco de RAM indicado
+    void moverARam(int indice, int marco) {
+        uint64_t pte = ptes[indice] & ~(MASCARA_UBICACION | PTE_SUCIA | PTE_ANTICIPADA);
+        ptes[indice] = pte | PTE_PRESENTE | PTE_REFERENCIADA | static_cast<uint64_t>(marco);
+    }
+
+    // Página ausente guardada en el marco de SWAP indicado
+    void moverASwap(int indice, int marco_swap) {
+        uint64_t pte = ptes[indice] & ~(MASCARA_UBICACION | PTE_PRESENTE | PTE_REFERENCIADA | PTE_SUCIA | PTE_ANTICIPADA);
+        ptes[indice] = pte | static_cast<uint64_t>(marco_swap);
+    }
+
+    // Cambia el marco de una página presente sin tocar sus bits (fusión o copia en escritura)
+    void reubicar(int indice, int marco) {
+        ptes[indice] = (ptes[indice] & ~MASCARA_UBICACION) | static_cast<uint64_t>(marco);
+    }
     
-    // Listas de procesos y páginas
-    vector<Proceso> procesos;   // Todos los procesos creados
-    vector<Pagina> paginas;     // Todas las páginas de todos los procesos
+    // La página nueva pasa a usar el marco (o la ranura) de otra: toma su ubicación y su
+    // contenido y entra a su anillo
+    void compartirCon(int indice, int otra) {
+        uint64_t pte = ptes[indice] & ~(MASCARA_UBICACION | PTE_PRESENTE | PTE_REFERENCIADA | PTE_SUCIA | PTE_ANTICIPADA);
+        ptes[indice] = pte | (ptes[otra] & (PTE_PRESENTE | MASCARA_UBICACION));
+        ids_contenido[indice] = ids_contenido[otra];
+        unirAnillos(indice, otra);
+    }
     
-    // Contadores y estado interno
-    int siguiente_pid;          // Siguiente ID disponible para procesos
-    int siguiente_id_pagina;    // Siguiente ID global para páginas
-    unsigned long long contador_carga; // Contador para tiempo de carga (FIFO)
+    // Junta los anillos (distintos) de dos páginas que ya están en la misma ubicación
+    void unirAnillos(int a, int b) {
+        int siguiente_a = siguientes[a], siguiente_b = siguientes[b];
+        siguientes[a] = siguiente_b;
+        anteriores[siguiente_b] = a;
+        siguientes[b] = siguiente_a;
+        anteriores[siguiente_a] = b;
+        ptes[a] |= PTE_COMPARTIDA;
+        ptes[b] |= PTE_COMPARTIDA;
+    }
     
-    // Estadísticas para reporte final
-    int fallos_pagina;          // Número total de fallos de página ocurridos
-    int procesos_creados;       // Número total de procesos creados
-    int procesos_finalizados;   // Número total de procesos finalizados
+    // Saca la página de su anillo; retorna otra página que sigue en él (-1 si no había).
+    // Si queda una sola, deja de estar compartida.
+    int separar(int indice) {
+        int siguiente = siguientes[indice];
+        ptes[indice] &= ~PTE_COMPARTIDA;
+        if (siguiente == indice) return -1;
+        int anterior = anteriores[indice];
+        siguientes[anterior] = siguiente;
+        anteriores[siguiente] = anterior;
+        anteriores[indice] = siguientes[indice] = indice;
+        if (siguientes[siguiente] == siguiente) ptes[siguiente] &= ~PTE_COMPARTIDA;
+        return siguiente;
+    }
+
+    void marcarReferenciada(int indice) { ptes[indice] |= PTE_REFERENCIADA; }
+    void marcarSucia(int indice) { ptes[indice] |= PTE_SUCIA; }
+    void marcarEnorme(int indice, bool enorme) {
+        ptes[indice] = enorme ? (ptes[indice] | PTE_ENORME) : (ptes[indice] & ~PTE_ENORME);
+    }
     
-    // Generador de números aleatorios
-    mt19937 generador_aleatorio;
+    // Página traída por lectura anticipada: presente pero todavía sin referenciar
+    void marcarAnticipada(int indice) { ptes[indice] = (ptes[indice] & ~PTE_REFERENCIADA) | PTE_ANTICIPADA; }
+    void desmarcarAnticipada(int indice) { ptes[indice] &= ~PTE_ANTICIPADA; }
 
-public:
-    // Constructor principal - inicializa toda la simulación
-    SimuladorMemoria(int mem_fisica_mb, int tam_pagina_mb, int proc_min_mb, int proc_max_mb) 
-        : memoria_fisica_mb(mem_fisica_mb),  // Memoria fisica en MB
-          tamano_pagina_mb(tam_pagina_mb),   // Tamaño de página en MB
-          proceso_min_mb(proc_min_mb),       // Tamaño minimo de cada proceso en MB
-          proceso_max_mb(proc_max_mb),       // Tamaño maximo de cada proceso en MB
-          siguiente_pid(1),                  // Empezar PIDs desde 1
-          siguiente_id_pagina(1),            // Empezar IDs de páginas desde 1
-          contador_carga(0),                 // Contador de carga inicializado en 0
-          fallos_pagina(0),                  // Contador de fallos de página en 0
-          procesos_creados(0),               // Contador de procesos creados en 0
-          procesos_finalizados(0),           // Contador de procesos finalizados en 0
-          generador_aleatorio(random_device{}()) {
-        
-        inicializarMemoria(); // Inicializar la memoria del sistema
+    uint64_t pte(int indice) const { return ptes[indice]; }
+    bool enRam(int indice) const { return ptes[indice] & PTE_PRESENTE; }
+    bool vivo(int indice) const { return ptes[indice] & PTE_VALIDA; }
+    bool anticipada(int indice) const { return ptes[indice] & PTE_ANTICIPADA; }
+    bool compartida(int indice) const { return ptes[indice] & PTE_COMPARTIDA; }
+    bool enorme(int indice) const { return ptes[indice] & PTE_ENORME; }
+    int siguienteCompartida(int indice) const { return siguientes[indice]; }
+    int ubicacion(int indice) const { return ptes[indice] & MASCARA_UBICACION; }
+    int dueno(int indice) const { return (ptes[indice] >> BIT_DUENO) & MASCARA_DUENO; }
+    int64_t idPagina(int indice) const { return ids_pagina[indice]; }
+    int64_t idGlobal(int indice) const { return ids_globales[indice]; }
+    int64_t idContenido(int indice) const { return ids_contenido[indice]; }
+    void asignarContenido(int indice, int64_t id_contenido) { ids_contenido[indice] = id_contenido; }
+    void asignarIdGlobal(int indice, int64_t id_global) { ids_globales[indice] = id_global; }
+    uint32_t generacion(int indice) const { return generaciones[indice]; }
+    size_t size() const { return num_vivas; }
+    size_t capacidad() const { return ptes.size(); }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.arreglo(ptes);
+        archivo.arreglo(ids_pagina);
+        archivo.arreglo(ids_globales);
+        archivo.arreglo(ids_contenido);
+        archivo.arreglo(anteriores);
+        archivo.arreglo(siguientes);
+        archivo.arreglo(generaciones);
+        archivo.valor(primera_libre);
+        archivo.valor(num_vivas);
     }
+};
 
-    // Inicializa la memoria física y virtual
-    void inicializarMemoria() {
-        // Calcular memoria virtual (entre 1.5 y 4.5 veces la física)
-        uniform_real_distribution<double> distribucion_factor(1.5, 4.5);
-        double memoria_virtual_mb = memoria_fisica_mb * distribucion_factor(generador_aleatorio);
+// ============================================================================
+// TLB (CACHÉ DE TRADUCCIONES)
+// ============================================================================
+
+// TLB asociativa por conjuntos delante de la tabla de páginas. Cada entrada guarda la
+// etiqueta (ASID << 37 | enorme << 36 | página virtual o región) + 1 (0 = inválida) y
+// el marco de RAM. Es unificada, como la STLB de x86: una página enorme ocupa una sola
+// entrada con el primer marco de su bloque, y con páginas enormes activas una búsqueda
+// que falla como página base se repite como región. Las etiquetas de un conjunto están
+// contiguas y rellenadas a múltiplos de 4, así la búsqueda compara varias etiquetas por
+// instrucción (AVX2 o SSE2) sin ramas por vía.
+class TLB {
+private:
+    int vias;                   // Vías por conjunto
+    int paso;                   // Vías rellenadas a múltiplo de 4 (distancia entre conjuntos)
+    size_t num_conjuntos;
+    bool con_asid;              // false: se vacía en cada cambio de proceso
+    bool reemplazo_lru;         // false: FIFO (la marca de tiempo solo cambia al insertar)
+    bool con_enormes;           // Se buscan también entradas de páginas enormes
+    vector<uint64_t> etiquetas; // num_conjuntos * paso
+    vector<int> marcos;
+    vector<uint64_t> marcas;    // Última referencia (LRU) o inserción (FIFO)
+    uint64_t reloj;
+    int asid_actual;            // Proceso cuyas traducciones tiene la TLB (sin ASID)
+    
+    // Estadísticas
+    unsigned long long aciertos;
+    unsigned long long fallos;
+    unsigned long long derribos;   // Entradas invalidadas por expulsión o finalización
+    unsigned long long vaciados;   // Vaciados completos (cambios de proceso sin ASID)
+
+    static constexpr uint64_t MASCARA_PAGINA = (1ULL << BITS_PAGINA_VIRTUAL) - 1;
+    static constexpr uint64_t MASCARA_ASID = (1ULL << 27) - 1;
+
+    static uint64_t etiqueta(int asid, int64_t pagina, bool enorme = false) {
+        return ((static_cast<uint64_t>(asid) & MASCARA_ASID) << 37 | static_cast<uint64_t>(enorme) << 36 |
+                (static_cast<uint64_t>(pagina) & MASCARA_PAGINA)) + 1;
+    }
+
+    size_t conjunto(uint64_t valor) const {
+        return ((valor * 0x9E3779B97F4A7C15ULL) >> 32) % num_conjuntos;
+    }
+
+    // Posición de la etiqueta dentro del conjunto que empieza en base (-1 si no está)
+    int buscarEnConjunto(size_t base, uint64_t valor) const {
+        const uint64_t* fila = etiquetas.data() + base;
+#if defined(__AVX2__)
+        __m256i buscada = _mm256_set1_epi64x(static_cast<long long>(valor));
+        for (int v = 0; v < paso; v += 4) {
+            __m256i bloque = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fila + v));
+            int mascara = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(bloque, buscada)));
+            if (mascara) return v + __builtin_ctz(mascara);
+        }
+        return -1;
+#elif defined(__SSE2__)
+        // SSE2 no compara enteros de 64 bits: se comparan mitades de 32 y se combinan
+        __m128i buscada = _mm_set1_epi64x(static_cast<long long>(valor));
+        for (int v = 0; v < paso; v += 2) {
+            __m128i iguales = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(fila + v)), buscada);
+            iguales = _mm_and_si128(iguales, _mm_shuffle_epi32(iguales, _MM_SHUFFLE(2, 3, 0, 1)));
+            int mascara = _mm_movemask_pd(_mm_castsi128_pd(iguales));
+            if (mascara) return v + __builtin_ctz(mascara);
+        }
+        return -1;
+#else
+        for (int v = 0; v < vias; ++v) {
+            if (fila[v] == valor) return v;
+        }
+        return -1;
+#endif
+    }
+
+public:
+    TLB() : vias(0), paso(0), num_conjuntos(0), con_asid(true), reemplazo_lru(true), con_enormes(false), reloj(0),
+            asid_actual(-1), aciertos(0), fallos(0), derribos(0), vaciados(0) {}
+
+    // entradas = 0 desactiva la TLB; entradas debe ser múltiplo de vias
+    void inicializar(int entradas, int num_vias, bool asid, bool lru) {
+        if (entradas <= 0 || num_vias <= 0) return;
+        vias = num_vias;
+        paso = (vias + 3) & ~3;
+        num_conjuntos = entradas / vias;
+        con_asid = asid;
+        reemplazo_lru = lru;
+        etiquetas.assign(num_conjuntos * paso, 0);
+        marcos.assign(num_conjuntos * paso, -1);
+        marcas.assign(num_conjuntos * paso, 0);
+    }
+
+    bool activa() const { return num_conjuntos > 0; }
+    void habilitarEnormes() { con_enormes = true; }
+
+    // Sin ASID, pasar a otro proceso vacía toda la TLB
+    void cambiarContexto(int asid) {
+        if (asid == asid_actual) return;
+        if (!con_asid) vaciar();
+        asid_actual = asid;
+    }
+
+    // Marco de la página si la traducción está en la TLB (-1 = fallo de TLB)
+    int buscar(int asid, int64_t pagina) {
+        uint64_t valor = etiqueta(asid, pagina);
+        size_t base = conjunto(valor) * paso;
+        int via = buscarEnConjunto(base, valor);
+        int desplazamiento = 0;
+        if (via == -1 && con_enormes) {
+            // Traducción de la página enorme que la contiene: primer marco del bloque
+            valor = etiqueta(asid, pagina >> BITS_ENORME, true);
+            base = conjunto(valor) * paso;
+            via = buscarEnConjunto(base, valor);
+            desplazamiento = pagina & (PAGINAS_ENORME - 1);
+        }
+        if (via == -1) {
+            fallos++;
+            return -1;
+        }
+        aciertos++;
+        if (reemplazo_lru) marcas[base + via] = ++reloj;
+        return marcos[base + via] + desplazamiento;
+    }
+
+    // Agrega la traducción (tras un fallo de TLB), reemplazando una vía inválida o la más antigua
+    void insertar(int asid, int64_t pagina, int marco) { insertarEtiqueta(etiqueta(asid, pagina), marco); }
+
+    // Agrega una página enorme: la región y el primer marco de su bloque
+    void insertarEnorme(int asid, int64_t region, int primer_marco) {
+        insertarEtiqueta(etiqueta(asid, region, true), primer_marco);
+    }
+
+    void insertarEtiqueta(uint64_t valor, int marco) {
+        size_t base = conjunto(valor) * paso;
+        int victima = 0;
+        for (int v = 0; v < vias; ++v) {
+            if (etiquetas[base + v] == 0) {
+                victima = v;
+                break;
+            }
+            if (marcas[base + v] < marcas[base + victima]) victima = v;
+        }
+        etiquetas[base + victima] = valor;
+        marcos[base + victima] = marco;
+        marcas[base + victima] = ++reloj;
+    }
+
+    // Invalida la traducción de una página (su marco dejó de ser suyo)
+    void invalidar(int asid, int64_t pagina) { invalidarEtiqueta(etiqueta(asid, pagina)); }
+
+    // Invalida la entrada de una página enorme (se dividió)
+    void invalidarEnorme(int asid, int64_t region) { invalidarEtiqueta(etiqueta(asid, region, true)); }
+
+    void invalidarEtiqueta(uint64_t valor) {
+        size_t base = conjunto(valor) * paso;
+        int via = buscarEnConjunto(base, valor);
+        if (via == -1) return;
+        etiquetas[base + via] = 0;
+        derribos++;
+    }
+
+    // Invalida todas las traducciones de un proceso que termina
+    void invalidarProceso(int asid) {
+        if (!con_asid) {
+            // Sin ASID solo hay traducciones del proceso actual
+            if (asid == asid_actual) {
+                for (uint64_t& e : etiquetas) {
+                    derribos += (e != 0);
+                    e = 0;
+                }
+                asid_actual = -1;
+            }
+            return;
+        }
+        for (uint64_t& e : etiquetas) {
+            if (e != 0 && ((e - 1) >> 37) == (static_cast<uint64_t>(asid) & MASCARA_ASID)) {
+                e = 0;
+                derribos++;
+            }
+        }
+    }
+
+    void vaciar() {
+        fill(etiquetas.begin(), etiquetas.end(), 0);
+        vaciados++;
+    }
+
+    unsigned long long numAciertos() const { return aciertos; }
+    unsigned long long numFallos() const { return fallos; }
+    unsigned long long numDerribos() const { return derribos; }
+    unsigned long long numVaciados() const { return vaciados; }
+    size_t numEntradas() const { return num_conjuntos * vias; }
+    int numVias() const { return vias; }
+    bool usaAsid() const { return con_asid; }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.valor(vias);
+        archivo.valor(paso);
+        archivo.valor(num_conjuntos);
+        archivo.valor(con_asid);
+        archivo.valor(reemplazo_lru);
+        archivo.valor(con_enormes);
+        archivo.arreglo(etiquetas);
+        archivo.arreglo(marcos);
+        archivo.arreglo(marcas);
+        archivo.valor(reloj);
+        archivo.valor(asid_actual);
+        archivo.valor(aciertos);
+        archivo.valor(fallos);
+        archivo.valor(derribos);
+        archivo.valor(vaciados);
+    }
+};
+
+// ============================================================================
+// POLÍTICAS DE REEMPLAZO
+// ============================================================================
+//
+// Cada política es una clase que se entrega como parámetro de plantilla a
+// SimuladorMemoria, así las llamadas del camino de acceso se resuelven en tiempo
+// de compilación (sin funciones virtuales). Todas implementan:
+//
+//   static const char* nombre();
+//   void inicializar(size_t num_marcos);
+//   void alReferenciar(uint64_t clave);          // Antes de cada acceso (acierto o fallo)
+//   void alAcceder(int marco, uint64_t clave);   // Acierto: la página ya estaba en el marco
+//   void alCargar(int marco, uint64_t clave);    // Página cargada en el marco (creación o swap-in)
+//   int  elegirVictima(int excluido = -1);       // Marco a desalojar, saltando 'excluido' sin
+//                                                // cambiar su historia (-1 si no hay)
+//   void alExpulsar(int marco, uint64_t clave);  // La página del marco se movió a SWAP
+//   void alLiberar(int marco, uint64_t clave);   // La página del marco se liberó (fin de proceso)
+//
+// La clave identifica la página aunque no esté en RAM (ver clavePagina).
+
+// Clave estable de una página: PID en la parte alta y página virtual (36 bits) en la baja
+inline uint64_t clavePagina(int pid, int64_t id_pagina) {
+    return (static_cast<uint64_t>(pid) << BITS_PAGINA_VIRTUAL) | static_cast<uint64_t>(id_pagina);
+}
+
+// Lista acotada de claves de páginas ya desalojadas ("fantasmas" de 2Q y ARC).
+// Mantiene el orden de inserción y permite consultar y quitar cualquier clave en O(1).
+class ListaFantasma {
+private:
+    list<uint64_t> orden;                                     // Más antigua al frente
+    unordered_map<uint64_t, list<uint64_t>::iterator> indice; // Clave -> posición en 'orden'
+
+public:
+    bool contiene(uint64_t clave) const { return indice.count(clave) != 0; }
+    size_t size() const { return indice.size(); }
+
+    void insertar(uint64_t clave) {
+        quitar(clave);
+        orden.push_back(clave);
+        indice[clave] = prev(orden.end());
+    }
+
+    void quitar(uint64_t clave) {
+        auto it = indice.find(clave);
+        if (it == indice.end()) return;
+        orden.erase(it->second);
+        indice.erase(it);
+    }
+
+    void quitarMasAntigua() {
+        if (orden.empty()) return;
+        indice.erase(orden.front());
+        orden.pop_front();
+    }
+
+    void limpiar() {
+        orden.clear();
+        indice.clear();
+    }
+
+    // Se guardan las claves en orden; al restaurar el índice se reconstruye
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        vector<uint64_t> claves(orden.begin(), orden.end());
+        archivo.arreglo(claves);
+        if constexpr (Archivo::LECTURA) {
+            limpiar();
+            for (uint64_t clave : claves) insertar(clave);
+        }
+    }
+};
+
+// FIFO: desaloja la página que lleva más tiempo en RAM
+class PoliticaFIFO {
+private:
+    ListaMarcos cola;           // Marcos en orden de carga
+
+public:
+    static const char* nombre() { return "FIFO"; }
+    void inicializar(size_t num_marcos) { cola.inicializar(num_marcos); }
+    void alReferenciar(uint64_t) {}
+    void alAcceder(int, uint64_t) {}
+    void alCargar(int marco, uint64_t) { cola.insertar(marco); }
+    int elegirVictima(int excluido = -1) { return cola.frenteSin(excluido); }
+    void alExpulsar(int marco, uint64_t) { cola.quitar(marco); }
+    void alLiberar(int marco, uint64_t) { cola.quitar(marco); }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) { cola.serializar(archivo); }
+};
+
+// LRU: desaloja la página usada hace más tiempo
+class PoliticaLRU {
+private:
+    ListaMarcos recencia;       // Menos reciente al frente
+
+public:
+    static const char* nombre() { return "LRU"; }
+    void inicializar(size_t num_marcos) { recencia.inicializar(num_marcos); }
+    void alReferenciar(uint64_t) {}
+    void alAcceder(int marco, uint64_t) { recencia.moverAlFinal(marco); }
+    void alCargar(int marco, uint64_t) { recencia.insertar(marco); }
+    int elegirVictima(int excluido = -1) { return recencia.frenteSin(excluido); }
+    void alExpulsar(int marco, uint64_t) { recencia.quitar(marco); }
+    void alLiberar(int marco, uint64_t) { recencia.quitar(marco); }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) { recencia.serializar(archivo); }
+};
+
+// Clock (segunda oportunidad): una manecilla recorre los marcos y salta los que
+// tienen el bit de referencia encendido, apagándolo. Costo amortizado O(1).
+class PoliticaClock {
+private:
+    vector<char> residente;     // 1 si el marco tiene una página
+    vector<char> referencia;    // Bit de referencia de cada marco
+    size_t manecilla;           // Próximo marco a revisar
+    size_t num_residentes;      // Marcos con página
+
+public:
+    PoliticaClock() : manecilla(0), num_residentes(0) {}
+    static const char* nombre() { return "Clock"; }
+
+    void inicializar(size_t num_marcos) {
+        residente.assign(num_marcos, 0);
+        referencia.assign(num_marcos, 0);
+        manecilla = 0;
+        num_residentes = 0;
+    }
+
+    void alReferenciar(uint64_t) {}
+    void alAcceder(int marco, uint64_t) { referencia[marco] = 1; }
+
+    void alCargar(int marco, uint64_t) {
+        residente[marco] = 1;
+        referencia[marco] = 1;
+        num_residentes++;
+    }
+
+    int elegirVictima(int excluido = -1) {
+        bool solo_excluido = excluido != -1 && residente[excluido] && num_residentes == 1;
+        if (num_residentes == 0 || solo_excluido) return -1;
+        // Como mucho dos vueltas: la primera apaga todos los bits de referencia (el marco
+        // excluido se salta sin tocar su bit)
+        while (true) {
+            if (residente[manecilla] && int(manecilla) != excluido) {
+                if (!referencia[manecilla]) return manecilla;
+                referencia[manecilla] = 0; // Segunda oportunidad
+            }
+            manecilla = (manecilla + 1) % residente.size();
+        }
+    }
+
+    void alExpulsar(int marco, uint64_t clave) {
+        alLiberar(marco, clave);
+        manecilla = (marco + 1) % residente.size(); // La manecilla avanza tras reemplazar
+    }
+
+    void alLiberar(int marco, uint64_t) {
+        if (!residente[marco]) return;
+        residente[marco] = 0;
+        referencia[marco] = 0;
+        num_residentes--;
+    }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.arreglo(residente);
+        archivo.arreglo(referencia);
+        archivo.valor(manecilla);
+        archivo.valor(num_residentes);
+    }
+};
+
+// 2Q (Johnson y Shasha): las páginas nuevas entran a A1in (FIFO). Si se desalojan
+// desde ahí, su clave queda en A1out; una página que vuelve estando en A1out pasa a
+// Am (LRU), reservada para páginas con reutilización probada.
+class Politica2Q {
+private:
+    ListaMarcos a1_in;          // Residentes vistas una vez (FIFO)
+    ListaMarcos a_m;            // Residentes con reutilización (LRU)
+    ListaFantasma a1_out;       // Claves desalojadas desde A1in
+    size_t capacidad_in;        // Tamaño objetivo de A1in (25% de los marcos)
+    size_t capacidad_out;       // Tamaño máximo de A1out (50% de los marcos)
+
+public:
+    Politica2Q() : capacidad_in(1), capacidad_out(1) {}
+    static const char* nombre() { return "2Q"; }
+
+    void inicializar(size_t num_marcos) {
+        a1_in.inicializar(num_marcos);
+        a_m.inicializar(num_marcos);
+        a1_out.limpiar();
+        capacidad_in = max<size_t>(1, num_marcos / 4);
+        capacidad_out = max<size_t>(1, num_marcos / 2);
+    }
+
+    void alReferenciar(uint64_t) {}
+
+    void alAcceder(int marco, uint64_t) {
+        if (a_m.contiene(marco)) a_m.moverAlFinal(marco); // En A1in no se reordena
+    }
+
+    void alCargar(int marco, uint64_t clave) {
+        if (a1_out.contiene(clave)) {
+            a1_out.quitar(clave);
+            a_m.insertar(marco);
+        } else {
+            a1_in.insertar(marco);
+        }
+    }
+
+    int elegirVictima(int excluido = -1) {
+        bool desde_in = a1_in.size() > capacidad_in || a_m.size() == 0;
+        int marco = desde_in ? a1_in.frenteSin(excluido) : a_m.frenteSin(excluido);
+        if (marco == -1) marco = desde_in ? a_m.frenteSin(excluido) : a1_in.frenteSin(excluido);
+        return marco;
+    }
+
+    void alExpulsar(int marco, uint64_t clave) {
+        if (a1_in.contiene(marco)) {
+            a1_in.quitar(marco);
+            a1_out.insertar(clave);
+            if (a1_out.size() > capacidad_out) a1_out.quitarMasAntigua();
+        } else {
+            a_m.quitar(marco);
+        }
+    }
+
+    void alLiberar(int marco, uint64_t) {
+        a1_in.quitar(marco);
+        a_m.quitar(marco);
+    }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        a1_in.serializar(archivo);
+        a_m.serializar(archivo);
+        a1_out.serializar(archivo);
+        archivo.valor(capacidad_in);
+        archivo.valor(capacidad_out);
+    }
+};
+
+// ARC (Megiddo y Modha): T1 guarda páginas vistas una vez y T2 las reutilizadas;
+// B1 y B2 recuerdan las claves desalojadas de cada una. Un fallo sobre B1 agranda
+// el objetivo 'p' de T1 y uno sobre B2 lo achica, adaptándose a la carga.
+class PoliticaARC {
+private:
+    ListaMarcos t1;             // Residentes recientes (LRU al frente)
+    ListaMarcos t2;             // Residentes frecuentes (LRU al frente)
+    ListaFantasma b1;           // Claves desalojadas de T1
+    ListaFantasma b2;           // Claves desalojadas de T2
+    size_t capacidad;           // c: número de marcos
+    size_t objetivo_t1;         // p: tamaño objetivo de T1
+    uint64_t clave_pendiente;   // Página del acceso en curso
+    bool hay_pendiente;
+
+    // Mantiene |T1|+|B1| <= c y el total de las cuatro listas <= 2c
+    void recortarFantasmas() {
+        while (t1.size() + b1.size() > capacidad && b1.size() > 0) b1.quitarMasAntigua();
+        while (t1.size() + t2.size() + b1.size() + b2.size() > 2 * capacidad && b2.size() > 0) {
+            b2.quitarMasAntigua();
+        }
+    }
+
+public:
+    PoliticaARC() : capacidad(1), objetivo_t1(0), clave_pendiente(0), hay_pendiente(false) {}
+    static const char* nombre() { return "ARC"; }
+
+    void inicializar(size_t num_marcos) {
+        t1.inicializar(num_marcos);
+        t2.inicializar(num_marcos);
+        b1.limpiar();
+        b2.limpiar();
+        capacidad = max<size_t>(1, num_marcos);
+        objetivo_t1 = 0;
+        hay_pendiente = false;
+    }
+
+    void alReferenciar(uint64_t clave) {
+        clave_pendiente = clave;
+        hay_pendiente = true;
+        // Adaptación: un fallo que cae en un fantasma indica qué lista se quedó corta
+        if (b1.contiene(clave)) {
+            size_t delta = max<size_t>(1, b2.size() / b1.size());
+            objetivo_t1 = min(capacidad, objetivo_t1 + delta);
+        } else if (b2.contiene(clave)) {
+            size_t delta = max<size_t>(1, b1.size() / b2.size());
+            objetivo_t1 = (objetivo_t1 > delta) ? objetivo_t1 - delta : 0;
+        }
+    }
+
+    void alAcceder(int marco, uint64_t) {
+        hay_pendiente = false;
+        if (t1.contiene(marco)) {
+            t1.quitar(marco);
+            t2.insertar(marco);
+        } else {
+            t2.moverAlFinal(marco);
+        }
+    }
+
+    void alCargar(int marco, uint64_t clave) {
+        hay_pendiente = false;
+        if (b1.contiene(clave) || b2.contiene(clave)) {
+            b1.quitar(clave);
+            b2.quitar(clave);
+            t2.insertar(marco);
+        } else {
+            t1.insertar(marco);
+        }
+        recortarFantasmas();
+    }
+
+    // REPLACE de ARC: desaloja de T1 si supera su objetivo, si no de T2 (de la otra lista
+    // si la elegida solo tiene el marco excluido)
+    int elegirVictima(int excluido = -1) {
+        bool pendiente_en_b2 = hay_pendiente && b2.contiene(clave_pendiente);
+        bool desde_t1 = t1.size() > 0 &&
+            (t1.size() > objetivo_t1 || (pendiente_en_b2 && t1.size() == objetivo_t1) || t2.size() == 0);
+        int marco = desde_t1 ? t1.frenteSin(excluido) : t2.frenteSin(excluido);
+        if (marco == -1) marco = desde_t1 ? t2.frenteSin(excluido) : t1.frenteSin(excluido);
+        return marco;
+    }
+
+    void alExpulsar(int marco, uint64_t clave) {
+        if (t1.contiene(marco)) {
+            t1.quitar(marco);
+            b1.insertar(clave);
+        } else {
+            t2.quitar(marco);
+            b2.insertar(clave);
+        }
+        recortarFantasmas();
+    }
+
+    void alLiberar(int marco, uint64_t) {
+        t1.quitar(marco);
+        t2.quitar(marco);
+    }
+
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        t1.serializar(archivo);
+        t2.serializar(archivo);
+        b1.serializar(archivo);
+        b2.serializar(archivo);
+        archivo.valor(capacidad);
+        archivo.valor(objetivo_t1);
+        archivo.valor(clave_pendiente);
+        archivo.valor(hay_pendiente);
+    }
+};
+
+// OPT (Belady): desaloja la página cuyo próximo uso está más lejos en el futuro.
+// Es una política fuera de línea: necesita conocer la secuencia completa de accesos
+// (cargarFuturo), por lo que solo tiene sentido al reproducir trazas. Con el futuro
+// precalculado cada operación cuesta O(log n) sobre un conjunto ordenado.
+class PoliticaOPT {
+private:
+    static constexpr size_t NUNCA = numeric_limits<size_t>::max(); // Sin uso futuro
+
+    vector<uint64_t> futuro;                 // Claves en el orden en que serán accedidas
+    vector<size_t> siguiente_uso;            // Para cada posición, la siguiente de la misma clave
+    unordered_map<uint64_t, size_t> proximo; // Próxima posición en que se usará cada clave
+    size_t cursor;                           // Posición del acceso en curso
+
+    set<pair<size_t, int>> orden;            // (próximo uso, marco) de las páginas residentes
+    vector<size_t> prioridad_marco;          // Próximo uso registrado para cada marco
+
+    size_t proximoUso(uint64_t clave) const {
+        auto it = proximo.find(clave);
+        return it == proximo.end() ? NUNCA : it->second;
+    }
+
+    void registrar(int marco, uint64_t clave) {
+        prioridad_marco[marco] = proximoUso(clave);
+        orden.insert({prioridad_marco[marco], marco});
+    }
+
+public:
+    PoliticaOPT() : cursor(0) {}
+    static const char* nombre() { return "OPT"; }
+
+    // Entrega la secuencia completa de claves que se accederán
+    void cargarFuturo(const vector<uint64_t>& secuencia) {
+        futuro = secuencia;
+        siguiente_uso.assign(futuro.size(), NUNCA);
+        proximo.clear();
+        // Recorrido hacia atrás: la última aparición vista es el siguiente uso
+        for (size_t i = futuro.size(); i-- > 0;) {
+            auto it = proximo.find(futuro[i]);
+            if (it != proximo.end()) siguiente_uso[i] = it->second;
+            proximo[futuro[i]] = i;
+        }
+        cursor = 0;
+    }
+
+    bool tieneFuturo() const { return !futuro.empty(); }
+
+    void inicializar(size_t num_marcos) {
+        orden.clear();
+        prioridad_marco.assign(num_marcos, NUNCA);
+    }
+
+    // Avanza el cursor hasta esta referencia. Si el simulador omitió accesos de la
+    // secuencia (por ejemplo, de un proceso que no pudo crearse) se saltan aquí. Los
+    // marcos cuyo próximo uso era una posición saltada toman el uso siguiente, así las
+    // prioridades no quedan viejas y la elección sigue siendo la de Belady (el marco
+    // de esta referencia lo actualiza alAcceder o alCargar).
+    void alReferenciar(uint64_t clave) {
+        while (cursor < futuro.size()) {
+            uint64_t actual = futuro[cursor];
+            size_t siguiente = siguiente_uso[cursor];
+            proximo[actual] = siguiente;
+            if (actual == clave) {
+                cursor++;
+                break;
+            }
+            auto it = orden.lower_bound({cursor, numeric_limits<int>::min()});
+            while (it != orden.end() && it->first == cursor) {
+                int marco = it->second;
+                it = orden.erase(it);
+                prioridad_marco[marco] = siguiente;
+                orden.insert({siguiente, marco});
+            }
+            cursor++;
+        }
+    }
+
+    void alAcceder(int marco, uint64_t clave) {
+        orden.erase({prioridad_marco[marco], marco});
+        registrar(marco, clave);
+    }
+
+    void alCargar(int marco, uint64_t clave) { registrar(marco, clave); }
+
+    int elegirVictima(int excluido = -1) {
+        if (orden.empty()) return -1;
+        auto candidato = prev(orden.end());
+        if (candidato->second == excluido) {
+            if (candidato == orden.begin()) return -1;
+            --candidato;
+        }
+        return candidato->second;
+    }
+
+    void alExpulsar(int marco, uint64_t) { orden.erase({prioridad_marco[marco], marco}); }
+    void alLiberar(int marco, uint64_t) { orden.erase({prioridad_marco[marco], marco}); }
+
+    // El mapa de próximos usos y el conjunto ordenado se guardan como arreglos paralelos
+    template <class Archivo>
+    void serializar(Archivo& archivo) {
+        archivo.arreglo(futuro);
+        archivo.arreglo(siguiente_uso);
+        archivo.valor(cursor);
+        archivo.arreglo(prioridad_marco);
+        vector<uint64_t> claves;
+        vector<size_t> usos;
+        for (const auto& entrada : proximo) {
+            claves.push_back(entrada.first);
+            usos.push_back(entrada.second);
+        }
+        archivo.arreglo(claves);
+        archivo.arreglo(usos);
+        vector<int> residentes;
+        for (const auto& entrada : orden) residentes.push_back(entrada.second);
+        archivo.arreglo(residentes);
+        if constexpr (Archivo::LECTURA) {
+            proximo.clear();
+            for (size_t i = 0; i < claves.size() && i < usos.size(); ++i) proximo[claves[i]] = usos[i];
+            orden.clear();
+            for (int marco : residentes) {
+                if (marco >= 0 && size_t(marco) < prioridad_marco.size()) orden.insert({prioridad_marco[marco], marco});
+            }
+        }
+    }
+};
+
+// ============================================================================
+// TRAZAS DE ACCESOS (FORMATO BINARIO)
+// ============================================================================
+//
+// Archivo .trz (little-endian):
+//   CabeceraTraza                       32 bytes
+//   RegistroTraza x num_registros       16 bytes cada uno
+//   ProcesoTraza  x num_procesos        24 bytes cada uno
+//
+// Cada registro identifica al proceso por su posición en la tabla de procesos (no por
+// su PID original), así la reproducción lo resuelve con un índice directo. La tabla
+// guarda la mayor dirección usada (para dimensionar el proceso al crearlo) y el último
+// registro del proceso (para finalizarlo cuando ya no tiene más accesos).
+
+const uint32_t TRAZA_VERSION = 1;
+const uint64_t TRAZA_BIT_ESCRITURA = 1ULL << 63;
+
+struct CabeceraTraza {
+    char magia[4];                   // "TRZ1"
+    uint32_t version;                // TRAZA_VERSION
+    uint64_t num_registros;          // Accesos en el archivo
+    uint32_t num_procesos;           // Entradas de la tabla de procesos
+    uint32_t reservado;
+    uint64_t desplazamiento_procesos; // Byte donde empieza la tabla de procesos
+};
+
+struct RegistroTraza {
+    uint64_t direccion;              // Dirección virtual; el bit 63 indica escritura
+    uint32_t proceso;                // Índice en la tabla de procesos
+    uint32_t delta_us;               // Microsegundos desde el registro anterior
+};
+
+struct ProcesoTraza {
+    uint32_t pid;                    // PID original de la traza
+    uint32_t reservado;
+    uint64_t direccion_maxima;       // Mayor dirección virtual accedida
+    uint64_t ultimo_registro;        // Índice del último acceso del proceso
+};
+
+static_assert(sizeof(CabeceraTraza) == 32, "CabeceraTraza debe medir 32 bytes");
+static_assert(sizeof(RegistroTraza) == 16, "RegistroTraza debe medir 16 bytes");
+static_assert(sizeof(ProcesoTraza) == 24, "ProcesoTraza debe medir 24 bytes");
+
+// Lector de trazas mediante mmap: los registros se leen directo del archivo mapeado,
+// sin copiar ni reservar memoria por registro.
+class LectorTraza {
+private:
+    int descriptor;                  // Archivo abierto (-1 si no hay)
+    const char* datos;               // Archivo mapeado en memoria
+    size_t tamano;                   // Bytes mapeados
+    const CabeceraTraza* cabecera;
+    string error;                    // Descripción del último error
+
+public:
+    LectorTraza() : descriptor(-1), datos(nullptr), tamano(0), cabecera(nullptr) {}
+    LectorTraza(const LectorTraza&) = delete;
+    LectorTraza& operator=(const LectorTraza&) = delete;
+
+    ~LectorTraza() {
+        if (datos != nullptr) munmap(const_cast<char*>(datos), tamano);
+        if (descriptor != -1) close(descriptor);
+    }
+
+    // Abre y valida el archivo; retorna false y deja el motivo en obtenerError()
+    bool abrir(const string& ruta) {
+        descriptor = open(ruta.c_str(), O_RDONLY);
+        if (descriptor == -1) {
+            error = "no se pudo abrir " + ruta;
+            return false;
+        }
+        struct stat info;
+        if (fstat(descriptor, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(CabeceraTraza))) {
+            error = "archivo de traza demasiado corto";
+            return false;
+        }
+        tamano = info.st_size;
+        void* mapa = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapa == MAP_FAILED) {
+            error = "mmap falló";
+            return false;
+        }
+        datos = static_cast<const char*>(mapa);
+        madvise(mapa, tamano, MADV_SEQUENTIAL); // Lectura secuencial: lectura anticipada agresiva
+
+        cabecera = reinterpret_cast<const CabeceraTraza*>(datos);
+        if (memcmp(cabecera->magia, "TRZ1", 4) != 0 || cabecera->version != TRAZA_VERSION) {
+            error = "formato o versión de traza no reconocidos";
+            return false;
+        }
+        uint64_t fin_registros = sizeof(CabeceraTraza) + cabecera->num_registros * sizeof(RegistroTraza);
+        uint64_t fin_procesos = cabecera->desplazamiento_procesos + cabecera->num_procesos * sizeof(ProcesoTraza);
+        if (fin_registros > tamano || cabecera->desplazamiento_procesos < fin_registros || fin_procesos > tamano) {
+            error = "traza truncada";
+            return false;
+        }
+        return true;
+    }
+
+    const RegistroTraza* registros() const {
+        return reinterpret_cast<const RegistroTraza*>(datos + sizeof(CabeceraTraza));
+    }
+    const ProcesoTraza* procesosTraza() const {
+        return reinterpret_cast<const ProcesoTraza*>(datos + cabecera->desplazamiento_procesos);
+    }
+    uint64_t numRegistros() const { return cabecera->num_registros; }
+    uint32_t numProcesos() const { return cabecera->num_procesos; }
+    const string& obtenerError() const { return error; }
+};
+
+// Convierte una traza de texto a formato binario. Cada línea es
+//   pid direccion R|W tiempo_us
+// (la dirección puede ir en hexadecimal con 0x; las líneas que empiezan con # se omiten).
+// Los registros se escriben por bloques, sin guardar la traza completa en memoria.
+bool convertirTraza(const string& ruta_texto, const string& ruta_binaria) {
+    FILE* entrada = fopen(ruta_texto.c_str(), "r");
+    if (entrada == nullptr) {
+        cout << COLOR_ERROR << "Error: No se pudo abrir " << ruta_texto << COLOR_RESET << endl;
+        return false;
+    }
+    FILE* salida = fopen(ruta_binaria.c_str(), "wb");
+    if (salida == nullptr) {
+        cout << COLOR_ERROR << "Error: No se pudo crear " << ruta_binaria << COLOR_RESET << endl;
+        fclose(entrada);
+        return false;
+    }
+
+    // Solo se borra la salida si es un archivo común (no, por ejemplo, un dispositivo)
+    struct stat info;
+    bool archivo_comun = fstat(fileno(salida), &info) == 0 && S_ISREG(info.st_mode);
+
+    // Cada escritura se verifica: un disco lleno no debe dejar una traza truncada
+    auto escribir = [salida](const void* datos, size_t tamano, size_t cantidad) {
+        return fwrite(datos, tamano, cantidad, salida) == cantidad;
+    };
+    CabeceraTraza cabecera{};
+    bool ok = escribir(&cabecera, sizeof(cabecera), 1); // Se reescribe al final
+    if (!ok) cout << COLOR_ERROR << "Error: No se pudo escribir " << ruta_binaria << COLOR_RESET << endl;
+
+    unordered_map<uint32_t, uint32_t> indice_por_pid; // PID original -> posición en la tabla
+    vector<ProcesoTraza> tabla;
+    vector<RegistroTraza> bloque;
+    bloque.reserve(65536);
+
+    char linea[256];
+    uint64_t num_registros = 0, tiempo_anterior = 0, linea_actual = 0;
+    while (ok && fgets(linea, sizeof(linea), entrada) != nullptr) {
+        linea_actual++;
+        if (linea[0] == '#' || linea[0] == '\n') continue;
+
+        unsigned long pid;
+        unsigned long long direccion, tiempo;
+        char tipo;
+        char texto_direccion[64];
+        if (sscanf(linea, "%lu %63s %c %llu", &pid, texto_direccion, &tipo, &tiempo) != 4 ||
+            (tipo != 'R' && tipo != 'W' && tipo != 'r' && tipo != 'w')) {
+            cout << COLOR_ERROR << "Error: Línea " << linea_actual << " inválida en la traza" << COLOR_RESET << endl;
+            ok = false;
+            break;
+        }
+        direccion = strtoull(texto_direccion, nullptr, 0) & ~TRAZA_BIT_ESCRITURA;
+
+        auto it = indice_por_pid.find(pid);
+        if (it == indice_por_pid.end()) {
+            it = indice_por_pid.emplace(pid, tabla.size()).first;
+            tabla.push_back(ProcesoTraza{static_cast<uint32_t>(pid), 0, 0, 0});
+        }
+        ProcesoTraza& proceso = tabla[it->second];
+        proceso.direccion_maxima = max<uint64_t>(proceso.direccion_maxima, direccion);
+        proceso.ultimo_registro = num_registros;
+
+        uint64_t delta = (num_registros == 0 || tiempo < tiempo_anterior) ? 0 : tiempo - tiempo_anterior;
+        tiempo_anterior = tiempo;
+        bool escritura = (tipo == 'W' || tipo == 'w');
+        bloque.push_back(RegistroTraza{direccion | (escritura ? TRAZA_BIT_ESCRITURA : 0), it->second,
+                                       static_cast<uint32_t>(min<uint64_t>(delta, numeric_limits<uint32_t>::max()))});
+        num_registros++;
+
+        if (bloque.size() == bloque.capacity()) {
+            if (!escribir(bloque.data(), sizeof(RegistroTraza), bloque.size())) {
+                cout << COLOR_ERROR << "Error: No se pudo escribir " << ruta_binaria << COLOR_RESET << endl;
+                ok = false;
+            }
+            bloque.clear();
+        }
+    }
+    fclose(entrada);
+
+    // Tabla de procesos y cabecera definitiva (solo si todo lo anterior salió bien)
+    if (ok) {
+        memcpy(cabecera.magia, "TRZ1", 4);
+        cabecera.version = TRAZA_VERSION;
+        cabecera.num_registros = num_registros;
+        cabecera.num_procesos = tabla.size();
+        cabecera.desplazamiento_procesos = sizeof(CabeceraTraza) + num_registros * sizeof(RegistroTraza);
+        ok = escribir(bloque.data(), sizeof(RegistroTraza), bloque.size()) &&
+             escribir(tabla.data(), sizeof(ProcesoTraza), tabla.size()) &&
+             fseek(salida, 0, SEEK_SET) == 0 && escribir(&cabecera, sizeof(cabecera), 1);
+        if (!ok) cout << COLOR_ERROR << "Error: No se pudo escribir " << ruta_binaria << COLOR_RESET << endl;
+    }
+    if (fclose(salida) != 0 && ok) {
+        cout << COLOR_ERROR << "Error: No se pudo escribir " << ruta_binaria << COLOR_RESET << endl;
+        ok = false;
+    }
+
+    // Una traza a medias no debe quedar con apariencia de válida
+    if (!ok) {
+        if (archivo_comun) remove(ruta_binaria.c_str());
+        return false;
+    }
+    cout << COLOR_INFO << "Traza convertida: " << num_registros << " accesos, " << tabla.size()
+         << " procesos → " << ruta_binaria << COLOR_RESET << endl;
+    return true;
+}
+
+// ============================================================================
+// REGISTRO DE EVENTOS
+// ============================================================================
+
+// Niveles de detalle del registro de texto
+enum class NivelRegistro {
+    SILENCIO = 0,               // No escribe nada
+    RESUMEN = 1,                // Configuración, estadísticas finales y fin de la simulación
+    EVENTOS = 2,                // Una línea por evento (creación, finalización, acceso, estado)
+    DETALLE = 3                 // Además, cada página cargada, liberada o reemplazada
+};
+
+// Tipos de registro del archivo de eventos binario
+enum class TipoEventoBinario : uint8_t {
+    CREACION = 1,               // pid, pagina = número de páginas
+    FINALIZACION = 2,           // pid
+    ACIERTO = 3,                // pid, página local, marco de RAM
+    FALLO = 4,                  // pid, página local, marco de RAM donde quedó
+    EXPULSION = 5,              // pid, página local, marco de SWAP donde quedó
+    ANTICIPACION = 6,           // pid, página local, marco de RAM (lectura anticipada)
+    COPIA_ESCRITURA = 7,        // pid, página local, marco de RAM propio tras la copia
+    FUSION = 8,                 // pid, página local, marco de RAM que ahora comparte
+    PRIMER_TOQUE = 9,           // pid, página local, marco de RAM (página creada por demanda)
+    ENORME = 10,                // pid, primera página de la región, primer marco del bloque
+    DIVISION = 11,              // pid, primera página de la región dividida
+    SUSPENSION = 12,            // pid, pagina = páginas enviadas a SWAP al suspenderlo
+    REANUDACION = 13            // pid, pagina = su conjunto de trabajo
+};
+
+// Registro del archivo de eventos binario (32 bytes, tras una cabecera "EVT1" + versión 2;
+// la versión 1 tenía la página en 32 bits y medía 24 bytes)
+struct EventoBinario {
+    double tiempo;              // Tiempo simulado
+    uint8_t tipo;               // TipoEventoBinario
+    uint8_t reservado[3];
+    int32_t pid;
+    int64_t pagina;             // Página virtual (64 bits)
+    int32_t marco;
+    int32_t reservado2;
+};
+
+static_assert(sizeof(EventoBinario) == 32, "EventoBinario debe medir 32 bytes");
+
+// Búfer de salida grande: acumula el texto y lo escribe por bloques con fwrite en
+// vez de vaciar la consola en cada línea como hacía endl.
+class BufferSalida : public streambuf {
+private:
+    vector<char> buffer;
+    FILE* destino;
+
+    bool vaciar() {
+        size_t pendiente = pptr() - pbase();
+        bool ok = fwrite(pbase(), 1, pendiente, destino) == pendiente;
+        setp(buffer.data(), buffer.data() + buffer.size());
+        return ok;
+    }
+
+protected:
+    int overflow(int caracter) override {
+        if (!vaciar()) return traits_type::eof();
+        if (caracter != traits_type::eof()) sputc(static_cast<char>(caracter));
+        return traits_type::not_eof(caracter);
+    }
+
+    int sync() override {
+        bool ok = vaciar();
+        fflush(destino);
+        return ok ? 0 : -1;
+    }
+
+public:
+    explicit BufferSalida(FILE* archivo, size_t capacidad = 1 << 20) : buffer(capacidad), destino(archivo) {
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+    ~BufferSalida() override { sync(); }
+};
+
+// Registro de la simulación: texto con niveles sobre un búfer grande y, opcionalmente,
+// un archivo binario compacto de eventos para procesar fuera de línea.
+class Registro {
+private:
+    // Destino del texto: la pantalla o un archivo (validarConfiguracion rechaza antes un
+    // archivo que no se puede crear; si aun así falla, la pantalla). Se declara antes del
+    // búfer para cerrarse después de que este se vacíe.
+    struct Destino {
+        FILE* archivo;
+        explicit Destino(const string& ruta) : archivo(ruta.empty() ? stdout : fopen(ruta.c_str(), "w")) {
+            if (archivo == nullptr) archivo = stdout;
+        }
+        ~Destino() {
+            if (archivo != stdout) fclose(archivo);
+        }
+    };
+
+    NivelRegistro nivel;
+    Destino destino;
+    BufferSalida buffer;
+    ostream salida;
+    FILE* archivo_binario;      // nullptr si no se pidió registro binario
+    vector<EventoBinario> pendientes; // Eventos binarios aún no escritos
+    unsigned long long eventos_binarios;
+
+    void vaciarBinario() {
+        if (archivo_binario == nullptr || pendientes.empty()) return;
+        fwrite(pendientes.data(), sizeof(EventoBinario), pendientes.size(), archivo_binario);
+        pendientes.clear();
+    }
+
+public:
+    explicit Registro(NivelRegistro nivel_inicial = NivelRegistro::DETALLE, const string& ruta_texto = "")
+        : nivel(nivel_inicial), destino(ruta_texto),
+          buffer(destino.archivo, nivel_inicial == NivelRegistro::SILENCIO ? 1 : 1 << 20),
+          salida(&buffer), archivo_binario(nullptr), eventos_binarios(0) {}
+    Registro(const Registro&) = delete;
+    Registro& operator=(const Registro&) = delete;
+
+    ~Registro() {
+        vaciar();
+        if (archivo_binario != nullptr) fclose(archivo_binario);
+    }
+
+    // Abre el archivo de eventos binario; retorna false si no se pudo crear
+    bool abrirBinario(const string& ruta) {
+        archivo_binario = fopen(ruta.c_str(), "wb");
+        if (archivo_binario == nullptr) return false;
+        const char magia[4] = {'E', 'V', 'T', '1'};
+        uint32_t version = 2;
+        fwrite(magia, 1, 4, archivo_binario);
+        fwrite(&version, sizeof(version), 1, archivo_binario);
+        pendientes.reserve(65536);
+        return true;
+    }
+
+    bool habilitado(NivelRegistro nivel_mensaje) const { return nivel_mensaje <= nivel; }
+    ostream& flujo() { return salida; }
+
+    // Agrega un evento binario (no hace nada si no hay archivo binario)
+    void binario(TipoEventoBinario tipo, double tiempo, int pid, int64_t pagina, int marco) {
+        if (archivo_binario == nullptr) return;
+        pendientes.push_back(EventoBinario{tiempo, static_cast<uint8_t>(tipo), {0, 0, 0}, pid, pagina, marco, 0});
+        eventos_binarios++;
+        if (pendientes.size() == pendientes.capacity()) vaciarBinario();
+    }
+
+    unsigned long long eventosBinarios() const { return eventos_binarios; }
+
+    // Escribe todo lo pendiente (texto y binario)
+    void vaciar() {
+        salida.flush();
+        vaciarBinario();
+        if (archivo_binario != nullptr) fflush(archivo_binario);
+    }
+};
+
+// Escribe en el registro solo si el nivel está habilitado. Con el nivel deshabilitado
+// el mensaje ni siquiera se formatea: el costo es una comparación de enteros.
+#define REGISTRAR(registro, nivel_mensaje, mensaje) \
+    do { if ((registro).habilitado(nivel_mensaje)) { (registro).flujo() << mensaje; } } while (0)
+
+// Convierte el nombre de un nivel de registro; retorna false si no existe
+bool leerNivelRegistro(const string& nombre, NivelRegistro& nivel) {
+    if (nombre == "silencio") nivel = NivelRegistro::SILENCIO;
+    else if (nombre == "resumen") nivel = NivelRegistro::RESUMEN;
+    else if (nombre == "eventos") nivel = NivelRegistro::EVENTOS;
+    else if (nombre == "detalle") nivel = NivelRegistro::DETALLE;
+    else return false;
+    return true;
+}
+
+// ============================================================================
+// MÉTRICAS
+// ============================================================================
+
+// Marca de tiempo barata para medir costos cortos: el contador de ciclos (TSC) en x86
+// y nanosegundos de steady_clock en otras arquitecturas
+inline uint64_t marcaTiempo() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Histograma con cubetas de potencias de 2: la cubeta i cuenta valores en [2^i, 2^(i+1))
+// (la 0 incluye el 0). Registrar es un conteo de ceros y un incremento.
+class HistogramaLog2 {
+public:
+    static const int NUM_CUBETAS = 64;
+
+private:
+    unsigned long long cubetas[NUM_CUBETAS];
+    unsigned long long cuenta;
+    unsigned long long suma;
+
+public:
+    HistogramaLog2() : cubetas(), cuenta(0), suma(0) {}
+
+    void registrar(uint64_t valor) {
+        cubetas[valor ? 63 - __builtin_clzll(valor) : 0]++;
+        cuenta++;
+        suma += valor;
+    }
+
+    // Límite superior de la cubeta donde cae el cuantil q (0..1); 0 si está vacío
+    uint64_t cuantil(double q) const {
+        if (cuenta == 0) return 0;
+        unsigned long long objetivo = static_cast<unsigned long long>(ceil(q * cuenta));
+        unsigned long long acumulado = 0;
+        for (int i = 0; i < NUM_CUBETAS; ++i) {
+            acumulado += cubetas[i];
+            if (acumulado >= objetivo && acumulado > 0) return limiteSuperior(i);
+        }
+        return limiteSuperior(NUM_CUBETAS - 1);
+    }
+
+    static uint64_t limiteSuperior(int cubeta) { return cubeta >= 63 ? ~0ULL : (2ULL << cubeta) - 1; }
+    unsigned long long cubeta(int i) const { return cubetas[i]; }
+    unsigned long long numValores() const { return cuenta; }
+    unsigned long long sumaValores() const { return suma; }
+};
+
+// Contadores que el simulador mantiene al vuelo (sin recorrer marcos ni páginas)
+struct Metricas {
+    unsigned long long expulsiones = 0;     // Páginas desalojadas de RAM por el reemplazo
+    unsigned long long swap_in = 0;         // Páginas traídas desde SWAP
+    unsigned long long swap_out = 0;        // Páginas enviadas a SWAP por expulsión
+    unsigned long long anticipadas = 0;     // Páginas traídas por lectura anticipada
+    unsigned long long aciertos_anticipados = 0; // Anticipadas que se usaron
+    unsigned long long anticipadas_sin_uso = 0;  // Anticipadas expulsadas o liberadas sin usarse
+    unsigned long long expulsiones_anticipacion = 0; // Expulsiones causadas por la anticipación
+    unsigned long long expulsiones_fondo = 0;    // Expulsiones del reclamador en segundo plano
+    unsigned long long recuperacion_directa = 0; // Fallos sin marco libre que expulsaron en línea
+    unsigned long long despertares_recuperacion = 0; // Veces que corrió el reclamador
+    unsigned long long forks = 0;                // Procesos creados como fork
+    unsigned long long copias_escritura = 0;     // Copias en escritura de páginas compartidas
+    unsigned long long fusiones_ksm = 0;         // Fusiones de páginas iguales del escáner
+    unsigned long long revisadas_ksm = 0;        // Páginas cuya suma calculó el escáner
+    unsigned long long pasadas_ksm = 0;          // Vueltas completas del escáner a la tabla
+    unsigned long long paginas_compartidas = 0;  // Páginas que usan el marco de otra (marcos ahorrados)
+    unsigned long long compartidas_pico = 0;     // Máximo de paginas_compartidas
+    unsigned long long fallos_demanda = 0;       // Páginas creadas en su primer acceso
+    unsigned long long enormes_mapeadas = 0;     // Regiones mapeadas como página enorme al crearse
+    unsigned long long enormes_promovidas = 0;   // Regiones promovidas por el promotor
+    unsigned long long enormes_divididas = 0;    // Páginas enormes divididas en páginas base
+    unsigned long long promociones_sin_bloque = 0; // Regiones aptas sin bloque alineado libre
+    unsigned long long regiones_enormes = 0;     // Páginas enormes mapeadas ahora
+    unsigned long long nodos_tabla = 0;          // Nodos de las tablas radix de los procesos vivos
+    unsigned long long nodos_tabla_pico = 0;     // Máximo de nodos_tabla
+    unsigned long long demanda_trabajo = 0;      // Suma de los conjuntos de trabajo activos (última revisión)
+    unsigned long long demanda_pico = 0;         // Máximo de demanda_trabajo
+    unsigned long long revisiones_control = 0;  // Veces que corrió el control de carga
+    unsigned long long sobrecargas = 0;          // Revisiones con más demanda que marcos de RAM
+    unsigned long long suspensiones = 0;         // Procesos suspendidos
+    unsigned long long reanudaciones = 0;        // Procesos reanudados
+    unsigned long long paginas_suspendidas = 0;  // Páginas enviadas a SWAP al suspender
+    unsigned long long llegadas_diferidas = 0;   // Llegadas que tuvieron que esperar
+    HistogramaLog2 costo_fallo;             // Costo de atender cada fallo (ciclos o ns)
+    
+    // Valores de la instantánea anterior, para tasas por intervalo
+    double tiempo_anterior = 0.0;
+    unsigned long long accesos_anteriores = 0;
+    unsigned long long fallos_anteriores = 0;
+};
+
+// ============================================================================
+// SWAP EN ARCHIVO (MODO CONTENIDO)
+// ============================================================================
+
+// Bloque de memoria alineado a 4 KB (requisito de O_DIRECT)
+class BufferAlineado {
+private:
+    uint8_t* datos;
+
+public:
+    BufferAlineado() : datos(nullptr) {}
+    ~BufferAlineado() { free(datos); }
+    BufferAlineado(const BufferAlineado&) = delete;
+    BufferAlineado& operator=(const BufferAlineado&) = delete;
+
+    bool reservar(size_t bytes) {
+        free(datos);
+        datos = static_cast<uint8_t*>(aligned_alloc(4096, (bytes + 4095) & ~size_t(4095)));
+        return datos != nullptr;
+    }
+    uint8_t* obtener() const { return datos; }
+};
+
+// Una lectura o escritura del archivo de SWAP. La escritura puede juntar varias páginas
+// de posiciones consecutivas del archivo (iovec) en una sola llamada.
+struct SolicitudES {
+    bool escritura = false;
+    vector<iovec> vectores;
+    off_t desplazamiento = 0;
+    size_t bytes = 0;
+    bool correcta = false;
+    uint64_t nanosegundos = 0;  // Latencia medida por el hilo que la atendió
+    bool terminada = false;     // Protegida por el cerrojo del pool
+};
+
+// Hilos que atienden la E/S del SWAP con preadv/pwritev. El simulador envía una
+// solicitud, sigue con su trabajo y solo espera cuando necesita el resultado.
+class PoolES {
+private:
+    int descriptor;
+    mutex cerrojo;
+    condition_variable hay_trabajo;
+    condition_variable hay_terminadas;
+    deque<SolicitudES*> cola;
+    vector<thread> hilos;
+    bool cerrando;
+
+    // Transfiere todos los bytes de la solicitud (reintenta las transferencias parciales)
+    bool transferir(SolicitudES& solicitud) {
+        vector<iovec> pendientes = solicitud.vectores;
+        size_t primero = 0;
+        off_t desplazamiento = solicitud.desplazamiento;
+        while (primero < pendientes.size()) {
+            ssize_t hecho = solicitud.escritura
+                ? pwritev(descriptor, pendientes.data() + primero, pendientes.size() - primero, desplazamiento)
+                : preadv(descriptor, pendientes.data() + primero, pendientes.size() - primero, desplazamiento);
+            if (hecho <= 0) return false;
+            desplazamiento += hecho;
+            while (hecho > 0) {
+                iovec& actual = pendientes[primero];
+                size_t parte = min<size_t>(hecho, actual.iov_len);
+                actual.iov_base = static_cast<uint8_t*>(actual.iov_base) + parte;
+                actual.iov_len -= parte;
+                hecho -= parte;
+                if (actual.iov_len == 0) primero++;
+            }
+        }
+        return true;
+    }
+
+    void trabajar() {
+        while (true) {
+            SolicitudES* solicitud;
+            {
+                unique_lock<mutex> guardia(cerrojo);
+                hay_trabajo.wait(guardia, [this]() { return cerrando || !cola.empty(); });
+                if (cola.empty()) return;
+                solicitud = cola.front();
+                cola.pop_front();
+            }
+            auto inicio = chrono::steady_clock::now();
+            bool correcta = transferir(*solicitud);
+            uint64_t nanosegundos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+            {
+                lock_guard<mutex> guardia(cerrojo);
+                solicitud->correcta = correcta;
+                solicitud->nanosegundos = nanosegundos;
+                solicitud->terminada = true;
+            }
+            hay_terminadas.notify_all();
+        }
+    }
+
+public:
+    PoolES(int fd, int num_hilos) : descriptor(fd), cerrando(false) {
+        for (int h = 0; h < max(1, num_hilos); ++h) hilos.emplace_back(&PoolES::trabajar, this);
+    }
+
+    ~PoolES() {
+        {
+            lock_guard<mutex> guardia(cerrojo);
+            cerrando = true;
+        }
+        hay_trabajo.notify_all();
+        for (thread& hilo : hilos) hilo.join();
+    }
+
+    void enviar(SolicitudES* solicitud) {
+        {
+            lock_guard<mutex> guardia(cerrojo);
+            cola.push_back(solicitud);
+        }
+        hay_trabajo.notify_one();
+    }
+
+    void esperar(SolicitudES* solicitud) {
+        unique_lock<mutex> guardia(cerrojo);
+        hay_terminadas.wait(guardia, [solicitud]() { return solicitud->terminada; });
+    }
+};
+
+// Archivo de SWAP: la ranura i ocupa los bytes [i × página, (i + 1) × página). Las
+// páginas expulsadas se copian a un lote en memoria; al llenarse, el lote se ordena
+// por ranura y cada tramo de ranuras consecutivas se escribe con un solo pwritev. Hay
+// dos lotes: mientras uno se escribe, el otro recibe expulsiones (y antes de enviar
+// uno se espera al anterior, así las escrituras de una ranura nunca se reordenan).
+// Una página que aún está en un lote se lee desde memoria.
+class AlmacenSwap {
+private:
+    struct Lote {
+        BufferAlineado datos;
+        vector<int> ranuras;             // Ranura de cada entrada (-1 = cancelada)
+        int usadas = 0;
+        vector<unique_ptr<SolicitudES>> escrituras; // En vuelo
+    };
+
+    int descriptor;
+    size_t bytes_pagina;
+    int capacidad_lote;
+    Lote lotes[2];
+    int actual;                          // Lote que recibe expulsiones
+    vector<int> en_lote;                 // Por ranura: lote × capacidad + entrada + 1 (0 = en disco)
+    unique_ptr<PoolES> pool;
+
+    // Estadísticas
+    unsigned long long lecturas;         // Lecturas del archivo (llamadas preadv)
+    unsigned long long paginas_leidas;   // Páginas leídas del archivo
+    unsigned long long lecturas_lote;    // Lecturas servidas desde un lote en memoria
+    unsigned long long escrituras;       // Llamadas pwritev
+    unsigned long long paginas_escritas;
+    unsigned long long errores;          // E/S fallidas o incompletas
+    double segundos_lectura;
+    double segundos_escritura;
+    HistogramaLog2 latencia_lectura;     // Microsegundos
+    HistogramaLog2 latencia_escritura;
+
+    uint8_t* entrada(int lote, int indice) const {
+        return lotes[lote].datos.obtener() + size_t(indice) * bytes_pagina;
+    }
+
+    // Espera las escrituras del lote y lo deja vacío
+    void esperarLote(int indice) {
+        Lote& lote = lotes[indice];
+        for (unique_ptr<SolicitudES>& solicitud : lote.escrituras) {
+            pool->esperar(solicitud.get());
+            escrituras++;
+            if (!solicitud->correcta) errores++;
+            segundos_escritura += solicitud->nanosegundos * 1e-9;
+            latencia_escritura.registrar(solicitud->nanosegundos / 1000);
+        }
+        lote.escrituras.clear();
+        for (int e = 0; e < lote.usadas; ++e) {
+            int ranura = lote.ranuras[e];
+            if (ranura != -1 && en_lote[ranura] == indice * capacidad_lote + e + 1) en_lote[ranura] = 0;
+        }
+        lote.usadas = 0;
+    }
+
+    // Escribe el lote actual en tramos de ranuras consecutivas y pasa al otro lote
+    void enviarLote() {
+        int otro = 1 - actual;
+        esperarLote(otro);
+        Lote& lote = lotes[actual];
+        vector<int> orden;
+        for (int e = 0; e < lote.usadas; ++e) {
+            if (lote.ranuras[e] != -1) orden.push_back(e);
+        }
+        sort(orden.begin(), orden.end(), [&lote](int a, int b) { return lote.ranuras[a] < lote.ranuras[b]; });
+        for (size_t i = 0; i < orden.size();) {
+            unique_ptr<SolicitudES> solicitud(new SolicitudES());
+            solicitud->escritura = true;
+            solicitud->desplazamiento = off_t(lote.ranuras[orden[i]]) * bytes_pagina;
+            size_t j = i;
+            do {
+                solicitud->vectores.push_back(iovec{entrada(actual, orden[j]), bytes_pagina});
+                j++;
+            } while (j < orden.size() && lote.ranuras[orden[j]] == lote.ranuras[orden[j - 1]] + 1);
+            solicitud->bytes = (j - i) * bytes_pagina;
+            paginas_escritas += j - i;
+            pool->enviar(solicitud.get());
+            lote.escrituras.push_back(move(solicitud));
+            i = j;
+        }
+        actual = otro;
+    }
+
+public:
+    AlmacenSwap() : descriptor(-1), bytes_pagina(0), capacidad_lote(0), actual(0), lecturas(0), paginas_leidas(0), lecturas_lote(0),
+                    escrituras(0), paginas_escritas(0), errores(0), segundos_lectura(0), segundos_escritura(0) {}
+
+    ~AlmacenSwap() {
+        if (pool) vaciar();
+        pool.reset();
+        if (descriptor != -1) close(descriptor);
+    }
+
+    // Crea el archivo de SWAP con num_ranuras páginas. Retorna false y el motivo si falla.
+    bool abrir(const string& ruta, size_t num_ranuras, size_t bytes, int lote, int hilos, bool directo, string& error) {
+        int banderas = O_RDWR | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+        if (directo) banderas |= O_DIRECT;
+#endif
+        descriptor = open(ruta.c_str(), banderas, 0600);
+        if (descriptor == -1) {
+            error = "No se pudo crear el archivo de SWAP " + ruta + ": " + strerror(errno);
+            return false;
+        }
+        if (ftruncate(descriptor, off_t(num_ranuras) * bytes) != 0) {
+            error = "No se pudo reservar el archivo de SWAP: " + string(strerror(errno));
+            return false;
+        }
+        bytes_pagina = bytes;
+        capacidad_lote = max(1, lote);
+        for (Lote& l : lotes) {
+            if (!l.datos.reservar(size_t(capacidad_lote) * bytes)) {
+                error = "Sin memoria para los lotes de SWAP";
+                return false;
+            }
+            l.ranuras.assign(capacidad_lote, -1);
+        }
+        en_lote.assign(num_ranuras, 0);
+        pool.reset(new PoolES(descriptor, hilos));
+        return true;
+    }
+
+    // Guarda la página en la ranura (se copia al lote; la escritura real llega después)
+    void escribir(int ranura, const uint8_t* contenido) {
+        Lote& lote = lotes[actual];
+        int e = lote.usadas++;
+        memcpy(entrada(actual, e), contenido, bytes_pagina);
+        lote.ranuras[e] = ranura;
+        en_lote[ranura] = actual * capacidad_lote + e + 1;
+        if (lote.usadas == capacidad_lote) enviarLote();
+    }
+
+    // Inicia la lectura de la ranura en destino. Retorna la solicitud a esperar, o
+    // nullptr si la página estaba en un lote y ya se copió.
+    unique_ptr<SolicitudES> leer(int ranura, uint8_t* destino) {
+        if (en_lote[ranura] != 0) {
+            int posicion = en_lote[ranura] - 1;
+            memcpy(destino, entrada(posicion / capacidad_lote, posicion % capacidad_lote), bytes_pagina);
+            lecturas_lote++;
+            return nullptr;
+        }
+        unique_ptr<SolicitudES> solicitud(new SolicitudES());
+        solicitud->vectores.push_back(iovec{destino, bytes_pagina});
+        solicitud->desplazamiento = off_t(ranura) * bytes_pagina;
+        solicitud->bytes = bytes_pagina;
+        pool->enviar(solicitud.get());
+        return solicitud;
+    }
+
+    // Inicia la lectura de varias páginas (ranura, destino), p. ej. una lectura anticipada.
+    // Las que siguen en un lote se copian al momento; el resto se ordena por ranura y
+    // cada tramo de ranuras consecutivas se lee con un solo preadv. Las solicitudes a
+    // esperar quedan en 'solicitudes'.
+    void leerVarias(vector<pair<int, uint8_t*>>& pedidos, vector<unique_ptr<SolicitudES>>& solicitudes) {
+        size_t pendientes = 0;
+        for (size_t i = 0; i < pedidos.size(); ++i) {
+            int ranura = pedidos[i].first;
+            if (en_lote[ranura] != 0) {
+                int posicion = en_lote[ranura] - 1;
+                memcpy(pedidos[i].second, entrada(posicion / capacidad_lote, posicion % capacidad_lote), bytes_pagina);
+                lecturas_lote++;
+            } else {
+                pedidos[pendientes++] = pedidos[i];
+            }
+        }
+        pedidos.resize(pendientes);
+        sort(pedidos.begin(), pedidos.end());
+        for (size_t i = 0; i < pedidos.size();) {
+            unique_ptr<SolicitudES> solicitud(new SolicitudES());
+            solicitud->desplazamiento = off_t(pedidos[i].first) * bytes_pagina;
+            size_t j = i;
+            do {
+                solicitud->vectores.push_back(iovec{pedidos[j].second, bytes_pagina});
+                j++;
+            } while (j < pedidos.size() && pedidos[j].first == pedidos[j - 1].first + 1);
+            solicitud->bytes = (j - i) * bytes_pagina;
+            pool->enviar(solicitud.get());
+            solicitudes.push_back(move(solicitud));
+            i = j;
+        }
+    }
+
+    // Espera una lectura iniciada con leer() o leerVarias()
+    void esperar(unique_ptr<SolicitudES>& solicitud) {
+        if (!solicitud) return;
+        pool->esperar(solicitud.get());
+        lecturas++;
+        paginas_leidas += solicitud->bytes / bytes_pagina;
+        if (!solicitud->correcta) errores++;
+        segundos_lectura += solicitud->nanosegundos * 1e-9;
+        latencia_lectura.registrar(solicitud->nanosegundos / 1000);
+        solicitud.reset();
+    }
+
+    // La ranura quedó libre: si su página seguía en un lote, ya no hace falta escribirla
+    void liberar(int ranura) {
+        if (en_lote[ranura] == 0) return;
+        int posicion = en_lote[ranura] - 1;
+        lotes[posicion / capacidad_lote].ranuras[posicion % capacidad_lote] = -1;
+        en_lote[ranura] = 0;
+    }
+
+    // Escribe lo pendiente y espera toda la E/S
+    void vaciar() {
+        if (lotes[actual].usadas > 0) enviarLote();
+        esperarLote(0);
+        esperarLote(1);
+    }
+
+    unsigned long long numLecturas() const { return lecturas; }
+    unsigned long long numPaginasLeidas() const { return paginas_leidas; }
+    unsigned long long numLecturasLote() const { return lecturas_lote; }
+    unsigned long long numEscrituras() const { return escrituras; }
+    unsigned long long numPaginasEscritas() const { return paginas_escritas; }
+    unsigned long long numErrores() const { return errores; }
+    double segundosLectura() const { return segundos_lectura; }
+    double segundosEscritura() const { return segundos_escritura; }
+    const HistogramaLog2& latenciaLectura() const { return latencia_lectura; }
+    const HistogramaLog2& latenciaEscritura() const { return latencia_escritura; }
+    size_t bytesPagina() const { return bytes_pagina; }
+};
+
+// ============================================================================
+// CACHÉ COMPRIMIDA (ZSWAP)
+// ============================================================================
+
+inline uint32_t leer32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+inline uint64_t leer64(const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; }
+
+// Tabla hash del compresor, reutilizada entre páginas. Cada entrada guarda base +
+// posición + 1 y la base avanza en cada página, así las entradas viejas quedan
+// inválidas sin limpiar los 64 KB de la tabla (solo al desbordarse la base).
+struct TablaHashLZ {
+    static const int BITS = 14;
+    vector<uint32_t> posiciones;
+    uint32_t base = 0;
+};
+
+// Compresor LZ de la familia LZ4 (formato propio, sin dependencias). La salida es una
+// serie de secuencias: un byte de control (4 bits de largo de literales y 4 de largo de
+// coincidencia - 4), bytes de extensión de 255 para los largos grandes, los literales
+// y el desplazamiento de la coincidencia (16 bits). La última secuencia solo tiene
+// literales. Las coincidencias se buscan con una tabla hash de posiciones de 4 bytes;
+// tras muchos fallos seguidos se avanza más rápido, así los datos incompresibles se
+// descartan pronto. Retorna el tamaño comprimido, o 0 si no cabe en 'capacidad'.
+size_t comprimirLZ(const uint8_t* origen, size_t tamano, uint8_t* destino, size_t capacidad, TablaHashLZ& tabla) {
+    const int BITS_HASH = TablaHashLZ::BITS;
+    const size_t MINIMO = 4;
+    if (tabla.posiciones.empty() || tabla.base + uint64_t(tamano) >= numeric_limits<uint32_t>::max()) {
+        tabla.posiciones.assign(size_t(1) << BITS_HASH, 0);
+        tabla.base = 0;
+    }
+    const uint32_t base = tabla.base; // Las entradas <= base son de páginas anteriores
+    tabla.base += tamano;
+    size_t entrada = 0, ancla = 0, salida = 0;
+    
+    auto escribirLargo = [&](size_t resto) {
+        for (; resto >= 255; resto -= 255) {
+            if (salida >= capacidad) return false;
+            destino[salida++] = 255;
+        }
+        if (salida >= capacidad) return false;
+        destino[salida++] = static_cast<uint8_t>(resto);
+        return true;
+    };
+    // Escribe los literales [ancla, entrada) y, si largo > 0, la coincidencia
+    auto emitir = [&](size_t desplazamiento, size_t largo) {
+        size_t literales = entrada - ancla;
+        size_t extra = largo ? largo - MINIMO : 0;
+        if (salida >= capacidad) return false;
+        destino[salida++] = static_cast<uint8_t>((min<size_t>(literales, 15) << 4) | min<size_t>(extra, 15));
+        if (literales >= 15 && !escribirLargo(literales - 15)) return false;
+        if (salida + literales > capacidad) return false;
+        memcpy(destino + salida, origen + ancla, literales);
+        salida += literales;
+        if (largo == 0) return true;
+        if (salida + 2 > capacidad) return false;
+        destino[salida++] = static_cast<uint8_t>(desplazamiento);
+        destino[salida++] = static_cast<uint8_t>(desplazamiento >> 8);
+        return extra < 15 || escribirLargo(extra - 15);
+    };
+    
+    unsigned fallos_seguidos = 0;
+    while (entrada + MINIMO <= tamano) {
+        uint32_t secuencia = leer32(origen + entrada);
+        uint32_t& posicion = tabla.posiciones[(secuencia * 2654435761u) >> (32 - BITS_HASH)];
+        size_t candidato = posicion > base ? posicion - base : 0;
+        posicion = base + static_cast<uint32_t>(entrada + 1);
+        if (candidato == 0 || entrada - (candidato - 1) > 65535 || leer32(origen + candidato - 1) != secuencia) {
+            entrada += 1 + (fallos_seguidos++ >> 6);
+            continue;
+        }
+        fallos_seguidos = 0;
+        size_t referencia = candidato - 1;
+        size_t largo = MINIMO;
+        while (entrada + largo + 8 <= tamano) {
+            uint64_t diferencia = leer64(origen + entrada + largo) ^ leer64(origen + referencia + largo);
+            if (diferencia != 0) {
+                largo += __builtin_ctzll(diferencia) / 8;
+                break;
+            }
+            largo += 8;
+        }
+        if (entrada + largo + 8 > tamano) {
+            while (entrada + largo < tamano && origen[referencia + largo] == origen[entrada + largo]) largo++;
+        }
+        if (!emitir(entrada - referencia, largo)) return 0;
+        entrada += largo;
+        ancla = entrada;
+    }
+    entrada = tamano;
+    return emitir(0, 0) ? salida : 0;
+}
+
+// Descomprime la salida de comprimirLZ. Verifica cada largo y desplazamiento, así una
+// entrada dañada no escribe fuera del destino. Retorna false si no produce 'tamano' bytes.
+bool descomprimirLZ(const uint8_t* origen, size_t bytes, uint8_t* destino, size_t tamano) {
+    size_t entrada = 0, salida = 0;
+    auto leerLargo = [&](size_t& largo) {
+        uint8_t byte;
+        do {
+            if (entrada >= bytes) return false;
+            byte = origen[entrada++];
+            largo += byte;
+        } while (byte == 255);
+        return true;
+    };
+    while (entrada < bytes) {
+        uint8_t control = origen[entrada++];
+        size_t literales = control >> 4;
+        if (literales == 15 && !leerLargo(literales)) return false;
+        if (literales > bytes - entrada || literales > tamano - salida) return false;
+        memcpy(destino + salida, origen + entrada, literales);
+        entrada += literales;
+        salida += literales;
+        if (entrada == bytes) break; // Última secuencia: solo literales
+        if (entrada + 2 > bytes) return false;
+        size_t desplazamiento = origen[entrada] | (size_t(origen[entrada + 1]) << 8);
+        entrada += 2;
+        size_t largo = control & 15;
+        if (largo == 15 && !leerLargo(largo)) return false;
+        largo += 4;
+        if (desplazamiento == 0 || desplazamiento > salida || largo > tamano - salida) return false;
+        uint8_t* copia = destino + salida;
+        if (desplazamiento >= largo) memcpy(copia, copia - desplazamiento, largo);
+        else for (size_t i = 0; i < largo; ++i) copia[i] = copia[i - desplazamiento]; // Se solapa: byte a byte
+        salida += largo;
+    }
+    return salida == tamano;
+}
+
+// Caché comprimida delante del archivo de SWAP, como zswap: la página expulsada
+// conserva su ranura de SWAP, pero sus bytes se comprimen y quedan en RAM. El pool es
+// una arena de 'presupuesto' bytes dividida en bloques del tamaño de una página; cada
+// bloque pertenece a una clase de tamaño (múltiplos de 1/64 de página) y se reparte en
+// espacios iguales, así reservar y liberar es tomar o devolver un espacio de una lista.
+// Las páginas que no bajan del umbral van directo al archivo, y cuando el pool se llena
+// se devuelven al archivo las guardadas hace más tiempo.
+class CacheComprimida {
+private:
+    static constexpr int NUM_CLASES = 64;
+
+    struct Bloque {
+        int clase = -1;                   // -1 = libre
+        int posicion_parcial = -1;        // Posición en parciales[clase] (-1 = lleno o libre)
+        vector<uint16_t> espacios_libres;
+    };
+    struct Entrada {
+        int bloque = -1;                  // -1 = la ranura no está en la caché
+        uint16_t espacio = 0;
+        uint32_t bytes = 0;               // Tamaño comprimido
+    };
+
+    AlmacenSwap& archivo;
+    size_t bytes_pagina;
+    size_t granulo;                       // Tamaño de la clase 0
+    size_t limite_comprimido;             // Mayor tamaño comprimido aceptado
+    BufferAlineado arena;
+    vector<Bloque> bloques;
+    vector<int> bloques_libres;
+    vector<int> parciales[NUM_CLASES];    // Bloques de cada clase con espacios libres
+    vector<Entrada> entradas;             // Por ranura de SWAP
+    ListaMarcos antiguedad;               // Ranuras guardadas, la más antigua al frente
+    BufferAlineado comprimida;            // Salida del compresor
+    BufferAlineado pagina;                // Página descomprimida para devolverla al archivo
+    TablaHashLZ tabla_hash;
+
+    // Estadísticas
+    unsigned long long guardadas;         // Páginas aceptadas
+    unsigned long long incompresibles;    // Rechazadas por no bajar del umbral
+    unsigned long long aciertos;          // Swap-in servidos desde la caché
+    unsigned long long fallos;            // Swap-in que tuvieron que ir al archivo
+    unsigned long long devueltas;         // Expulsadas de la caché al archivo
+    unsigned long long errores;           // Descompresiones fallidas
+    unsigned long long bytes_originales;  // De las páginas aceptadas
+    unsigned long long bytes_comprimidos;
+    size_t bytes_guardados;               // Comprimidos vivos en la caché
+    double segundos_compresion;
+    double segundos_descompresion;
+
+    size_t tamanoClase(int clase) const { return (clase + 1) * granulo; }
+    uint8_t* espacio(const Entrada& entrada) const {
+        return arena.obtener() + size_t(entrada.bloque) * bytes_pagina + entrada.espacio * tamanoClase(bloques[entrada.bloque].clase);
+    }
+
+    void quitarDeParciales(int indice) {
+        Bloque& bloque = bloques[indice];
+        vector<int>& lista = parciales[bloque.clase];
+        lista[bloque.posicion_parcial] = lista.back();
+        bloques[lista.back()].posicion_parcial = bloque.posicion_parcial;
+        lista.pop_back();
+        bloque.posicion_parcial = -1;
+    }
+
+    // Toma un espacio de la clase: de un bloque parcial o de un bloque libre
+    bool reservar(int clase, Entrada& entrada) {
+        if (parciales[clase].empty()) {
+            if (bloques_libres.empty()) return false;
+            int indice = bloques_libres.back();
+            bloques_libres.pop_back();
+            Bloque& bloque = bloques[indice];
+            bloque.clase = clase;
+            size_t num_espacios = bytes_pagina / tamanoClase(clase);
+            bloque.espacios_libres.clear();
+            for (size_t e = num_espacios; e-- > 0;) bloque.espacios_libres.push_back(e);
+            bloque.posicion_parcial = parciales[clase].size();
+            parciales[clase].push_back(indice);
+        }
+        int indice = parciales[clase].back();
+        Bloque& bloque = bloques[indice];
+        entrada.bloque = indice;
+        entrada.espacio = bloque.espacios_libres.back();
+        bloque.espacios_libres.pop_back();
+        if (bloque.espacios_libres.empty()) quitarDeParciales(indice);
+        return true;
+    }
+
+    // Devuelve el espacio de la ranura; un bloque que queda vacío vuelve a estar libre
+    void soltar(int ranura) {
+        Entrada& entrada = entradas[ranura];
+        Bloque& bloque = bloques[entrada.bloque];
+        bool estaba_lleno = bloque.espacios_libres.empty();
+        bloque.espacios_libres.push_back(entrada.espacio);
+        if (estaba_lleno) {
+            bloque.posicion_parcial = parciales[bloque.clase].size();
+            parciales[bloque.clase].push_back(entrada.bloque);
+        }
+        if (bloque.espacios_libres.size() == bytes_pagina / tamanoClase(bloque.clase)) {
+            quitarDeParciales(entrada.bloque);
+            bloque.clase = -1;
+            bloques_libres.push_back(entrada.bloque);
+        }
+        bytes_guardados -= entrada.bytes;
+        antiguedad.quitar(ranura);
+        entrada.bloque = -1;
+    }
+
+    bool descomprimir(int ranura, uint8_t* destino) {
+        const Entrada& entrada = entradas[ranura];
+        auto inicio = chrono::steady_clock::now();
+        bool correcta = descomprimirLZ(espacio(entrada), entrada.bytes, destino, bytes_pagina);
+        segundos_descompresion += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (!correcta) errores++;
+        return correcta;
+    }
+
+    // Devuelve al archivo la página guardada hace más tiempo
+    void devolverMasAntigua() {
+        int ranura = antiguedad.frente();
+        descomprimir(ranura, pagina.obtener());
+        archivo.escribir(ranura, pagina.obtener());
+        soltar(ranura);
+        devueltas++;
+    }
+
+public:
+    CacheComprimida(AlmacenSwap& almacen, size_t num_ranuras, size_t bytes, size_t presupuesto, double umbral)
+        : archivo(almacen), bytes_pagina(bytes), granulo(max<size_t>(1, bytes / NUM_CLASES)),
+          limite_comprimido(min(bytes, size_t(bytes * umbral))), guardadas(0), incompresibles(0), aciertos(0),
+          fallos(0), devueltas(0), errores(0), bytes_originales(0), bytes_comprimidos(0), bytes_guardados(0),
+          segundos_compresion(0), segundos_descompresion(0) {
+        size_t num_bloques = presupuesto / bytes;
+        bloques.resize(num_bloques);
+        for (size_t b = num_bloques; b-- > 0;) bloques_libres.push_back(b);
+        entradas.resize(num_ranuras);
+        antiguedad.inicializar(num_ranuras);
+    }
+
+    // Reserva la arena y los búferes; false si no hay memoria
+    bool abrir() {
+        return (bloques.empty() || arena.reservar(bloques.size() * bytes_pagina)) &&
+               comprimida.reservar(bytes_pagina) && pagina.reservar(bytes_pagina);
+    }
+
+    // Intenta guardar la página de la ranura. Retorna false si es incompresible o no
+    // cabe ni vaciando la caché; entonces quien llama la escribe en el archivo.
+    bool guardar(int ranura, const uint8_t* contenido) {
+        auto inicio = chrono::steady_clock::now();
+        size_t bytes = comprimirLZ(contenido, bytes_pagina, comprimida.obtener(), limite_comprimido, tabla_hash);
+        segundos_compresion += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (bytes == 0 || bloques.empty()) {
+            incompresibles++;
+            return false;
+        }
+        int clase = (bytes - 1) / granulo;
+        Entrada& entrada = entradas[ranura];
+        while (!reservar(clase, entrada)) {
+            if (antiguedad.size() == 0) return false;
+            devolverMasAntigua();
+        }
+        entrada.bytes = bytes;
+        memcpy(espacio(entrada), comprimida.obtener(), bytes);
+        antiguedad.insertar(ranura);
+        guardadas++;
+        bytes_originales += bytes_pagina;
+        bytes_comprimidos += bytes;
+        bytes_guardados += bytes;
+        return true;
+    }
+
+    // Swap-in: si la ranura está en la caché la descomprime en destino y la quita
+    bool cargar(int ranura, uint8_t* destino) {
+        if (entradas[ranura].bloque == -1) {
+            fallos++;
+            return false;
+        }
+        descomprimir(ranura, destino);
+        soltar(ranura);
+        aciertos++;
+        return true;
+    }
+
+    // La ranura quedó libre (su página se liberó)
+    void liberar(int ranura) {
+        if (entradas[ranura].bloque != -1) soltar(ranura);
+    }
+
+    unsigned long long numGuardadas() const { return guardadas; }
+    unsigned long long numIncompresibles() const { return incompresibles; }
+    unsigned long long numAciertos() const { return aciertos; }
+    unsigned long long numFallos() const { return fallos; }
+    unsigned long long numDevueltas() const { return devueltas; }
+    unsigned long long numErrores() const { return errores; }
+    double razonCompresion() const { return bytes_comprimidos ? double(bytes_originales) / bytes_comprimidos : 0.0; }
+    size_t bytesGuardados() const { return bytes_guardados; }
+    size_t bytesPool() const { return (bloques.size() - bloques_libres.size()) * bytes_pagina; }
+    size_t bytesPresupuesto() const { return bloques.size() * bytes_pagina; }
+    size_t paginasGuardadas() const { return antiguedad.size(); }
+    double segundosCompresion() const { return segundos_compresion; }
+    double segundosDescompresion() const { return segundos_descompresion; }
+    unsigned long long bytesOriginales() const { return bytes_originales; }
+};
+
+// ============================================================================
+// ESTADO GUARDADO DEL SIMULADOR (INSTANTÁNEAS PARA ARRANQUES EN CALIENTE)
+// ============================================================================
+//
+// Archivo de estado (little-endian, mismo programa que lo escribió):
+//   CabeceraEstado                      24 bytes
+//   Configuración (serializarConfiguracion)
+//   Estado del simulador (SimuladorMemoria::serializarEstado)
+//
+// Cada valor ocupa su tamaño nativo y cada arreglo va precedido por su cantidad de
+// elementos (uint64_t); todo se rellena a múltiplos de 8 bytes, así los arreglos quedan
+// alineados dentro del archivo mapeado. Las clases que forman el estado implementan
+//
+//   template <class Archivo> void serializar(Archivo& archivo);
+//
+// con las mismas llamadas para guardar (EscritorEstado) y restaurar (LectorEstado):
+// valor(), arreglo(), texto() y cantidad(). Lo que no es un arreglo plano (listas,
+// mapas, la cola de eventos) se copia a arreglos al guardar y se reconstruye al leer
+// según Archivo::LECTURA.
+
+const uint32_t ESTADO_VERSION = 2;
+
+struct CabeceraEstado {
+    char magia[4];                   // "EST1"
+    uint32_t version;                // ESTADO_VERSION
+    uint64_t tamano;                 // Bytes del archivo completo (detecta truncamiento)
+    uint32_t tamano_metricas;        // sizeof(Metricas) y sizeof(EstadoCarga) del programa que
+    uint32_t tamano_carga;           // lo escribió (se guardan byte a byte)
+};
+
+static_assert(sizeof(CabeceraEstado) == 24, "CabeceraEstado debe medir 24 bytes");
+
+// Escribe un estado con un búfer grande: el archivo se arma en una sola pasada y la
+// cabecera se reescribe al cerrar con el tamaño final
+class EscritorEstado {
+private:
+    FILE* archivo;                   // nullptr si no se pudo crear
+    vector<char> bufer;              // Búfer de stdio (debe vivir hasta fclose)
+    uint64_t escritos;               // Bytes escritos, cabecera incluida
+    bool ok;
+
+    void escribir(const void* datos, size_t bytes) {
+        static const char relleno[8] = {};
+        size_t sobrante = (8 - bytes % 8) % 8;
+        if (bytes > 0 && fwrite(datos, 1, bytes, archivo) != bytes) ok = false;
+        if (sobrante > 0 && fwrite(relleno, 1, sobrante, archivo) != sobrante) ok = false;
+        escritos += bytes + sobrante;
+    }
+
+public:
+    static constexpr bool LECTURA = false;
+
+    EscritorEstado() : archivo(nullptr), escritos(0), ok(false) {}
+    EscritorEstado(const EscritorEstado&) = delete;
+    EscritorEstado& operator=(const EscritorEstado&) = delete;
+
+    ~EscritorEstado() {
+        if (archivo != nullptr) fclose(archivo);
+    }
+
+    bool abrir(const string& ruta) {
+        archivo = fopen(ruta.c_str(), "wb");
+        if (archivo == nullptr) return false;
+        bufer.resize(1 << 20);
+        setvbuf(archivo, bufer.data(), _IOFBF, bufer.size());
+        CabeceraEstado cabecera{};
+        ok = true;
+        escribir(&cabecera, sizeof(cabecera)); // Se reescribe al cerrar
+        return ok;
+    }
+
+    template <class T>
+    void valor(T& dato) {
+        static_assert(is_trivially_copyable<T>::value, "solo se guardan valores copiables byte a byte");
+        escribir(&dato, sizeof(T));
+    }
+
+    template <class T>
+    void arreglo(vector<T>& datos) {
+        static_assert(is_trivially_copyable<T>::value, "solo se guardan arreglos de valores copiables byte a byte");
+        uint64_t cuenta = datos.size();
+        escribir(&cuenta, sizeof(cuenta));
+        escribir(datos.data(), datos.size() * sizeof(T));
+    }
+
+    void texto(string& cadena) {
+        uint64_t cuenta = cadena.size();
+        escribir(&cuenta, sizeof(cuenta));
+        escribir(cadena.data(), cadena.size());
+    }
+
+    // Cantidad de elementos de una colección que se guarda elemento por elemento
+    size_t cantidad(size_t cuenta) {
+        uint64_t valor = cuenta;
+        escribir(&valor, sizeof(valor));
+        return cuenta;
+    }
+
+    // Completa la cabecera y cierra; retorna false si falló alguna escritura
+    bool cerrar() {
+        CabeceraEstado cabecera{};
+        memcpy(cabecera.magia, "EST1", 4);
+        cabecera.version = ESTADO_VERSION;
+        cabecera.tamano = escritos;
+        cabecera.tamano_metricas = sizeof(Metricas);
+        cabecera.tamano_carga = sizeof(EstadoCarga);
+        if (fseek(archivo, 0, SEEK_SET) != 0 || fwrite(&cabecera, sizeof(cabecera), 1, archivo) != 1) ok = false;
+        if (fclose(archivo) != 0) ok = false;
+        archivo = nullptr;
+        return ok;
+    }
+
+    uint64_t bytes() const { return escritos; }
+};
+
+// Lee un estado mediante mmap: cada arreglo se copia con un solo memcpy desde el archivo
+// mapeado. Toda lectura revisa los límites; ante un archivo corto o inconsistente el
+// lector queda inválido y las lecturas siguientes no hacen nada.
+class LectorEstado {
+private:
+    int descriptor;                  // Archivo abierto (-1 si no hay)
+    const char* datos;               // Archivo mapeado en memoria
+    size_t tamano;                   // Bytes mapeados
+    size_t posicion;                 // Próximo byte a leer (siempre múltiplo de 8)
+    bool ok;
+    string error;                    // Descripción del primer error
+
+    void fallar(const string& motivo) {
+        if (ok) error = motivo;
+        ok = false;
+    }
+
+    // Avanza sobre 'bytes' bytes (más su relleno); nullptr si no alcanzan
+    const char* leer(size_t bytes) {
+        if (!ok) return nullptr;
+        if (bytes > tamano - posicion) {
+            fallar("estado truncado");
+            return nullptr;
+        }
+        const char* inicio = datos + posicion;
+        posicion = min(tamano, posicion + ((bytes + 7) & ~size_t(7)));
+        return inicio;
+    }
+
+public:
+    static constexpr bool LECTURA = true;
+
+    LectorEstado() : descriptor(-1), datos(nullptr), tamano(0), posicion(0), ok(false) {}
+    LectorEstado(const LectorEstado&) = delete;
+    LectorEstado& operator=(const LectorEstado&) = delete;
+
+    ~LectorEstado() {
+        if (datos != nullptr) munmap(const_cast<char*>(datos), tamano);
+        if (descriptor != -1) close(descriptor);
+    }
+
+    // Abre y valida la cabecera; retorna false y deja el motivo en obtenerError(). Para
+    // restaurar (completo) se carga el archivo entero al mapearlo, así las copias no pagan
+    // un fallo de página por cada 4 KB; para leer solo la configuración, no.
+    bool abrir(const string& ruta, bool completo = true) {
+        descriptor = open(ruta.c_str(), O_RDONLY);
+        if (descriptor == -1) {
+            error = "no se pudo abrir " + ruta;
+            return false;
+        }
+        struct stat info;
+        if (fstat(descriptor, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(CabeceraEstado))) {
+            error = "archivo de estado demasiado corto";
+            return false;
+        }
+        tamano = info.st_size;
+        void* mapa = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE | (completo ? MAP_POPULATE : 0), descriptor, 0);
+        if (mapa == MAP_FAILED) {
+            error = "mmap falló";
+            return false;
+        }
+        datos = static_cast<const char*>(mapa);
+
+        const CabeceraEstado* cabecera = reinterpret_cast<const CabeceraEstado*>(datos);
+        if (memcmp(cabecera->magia, "EST1", 4) != 0 || cabecera->version != ESTADO_VERSION) {
+            error = "formato o versión de estado no reconocidos";
+            return false;
+        }
+        if (cabecera->tamano != tamano) {
+            error = "estado truncado";
+            return false;
+        }
+        if (cabecera->tamano_metricas != sizeof(Metricas) || cabecera->tamano_carga != sizeof(EstadoCarga)) {
+            error = "el estado fue escrito por otra versión del simulador";
+            return false;
+        }
+        posicion = sizeof(CabeceraEstado);
+        ok = true;
+        return true;
+    }
+
+    template <class T>
+    void valor(T& dato) {
+        static_assert(is_trivially_copyable<T>::value, "solo se restauran valores copiables byte a byte");
+        const char* origen = leer(sizeof(T));
+        if (origen != nullptr) memcpy(&dato, origen, sizeof(T));
+    }
+
+    template <class T>
+    void arreglo(vector<T>& destino) {
+        static_assert(is_trivially_copyable<T>::value, "solo se restauran arreglos de valores copiables byte a byte");
+        uint64_t cuenta = 0;
+        valor(cuenta);
+        if (!ok || cuenta > (tamano - posicion) / sizeof(T)) {
+            fallar("estado truncado");
+            destino.clear();
+            return;
+        }
+        const T* origen = reinterpret_cast<const T*>(leer(cuenta * sizeof(T)));
+        if (origen == nullptr) return;
+        // Los arreglos grandes (la tabla de páginas) se piden con páginas enormes: llenar
+        // cientos de MB de a 4 KB cuesta más en fallos de página que en copiar
+        vector<T>().swap(destino);
+        destino.reserve(cuenta);
+        const size_t ENORME = 2 << 20;
+        uintptr_t inicio = (reinterpret_cast<uintptr_t>(destino.data()) + ENORME - 1) & ~(ENORME - 1);
+        uintptr_t fin = (reinterpret_cast<uintptr_t>(destino.data()) + cuenta * sizeof(T)) & ~(ENORME - 1);
+        if (fin > inicio) madvise(reinterpret_cast<void*>(inicio), fin - inicio, MADV_HUGEPAGE);
+        destino.assign(origen, origen + cuenta); // Una sola copia (los arreglos están alineados a 8 bytes)
+    }
+
+    void texto(string& cadena) {
+        uint64_t cuenta = 0;
+        valor(cuenta);
+        const char* origen = (cuenta <= tamano - posicion) ? leer(cuenta) : nullptr;
+        if (origen == nullptr) {
+            fallar("estado truncado");
+            cadena.clear();
+            return;
+        }
+        cadena.assign(origen, cuenta);
+    }
+
+    // Cantidad de elementos de una colección guardada elemento por elemento (cada uno
+    // ocupa al menos 8 bytes, así una cuenta corrupta no reserva memoria de más)
+    size_t cantidad(size_t) {
+        uint64_t cuenta = 0;
+        valor(cuenta);
+        if (cuenta > (tamano - posicion) / 8) {
+            fallar("estado truncado");
+            return 0;
+        }
+        return cuenta;
+    }
+
+    bool valido() const { return ok; }
+    bool completo() const { return ok && posicion == tamano; } // Se leyó el archivo entero
+    size_t bytes() const { return tamano; }
+    const string& obtenerError() const { return error; }
+};
+
+// Guarda o restaura todos los campos de la configuración
+template <class Archivo>
+void serializarConfiguracion(Archivo& archivo, ConfiguracionSimulacion& config) {
+    archivo.valor(config.memoria_fisica);
+    archivo.valor(config.tamano_pagina);
+    archivo.valor(config.proceso_min);
+    archivo.valor(config.proceso_max);
+    archivo.valor(config.semilla);
+    archivo.valor(config.tasa_llegadas);
+    archivo.valor(config.tasa_finalizaciones);
+    archivo.valor(config.tasa_accesos);
+    archivo.valor(config.intervalos_poisson);
+    archivo.valor(config.inicio_periodicos);
+    archivo.valor(config.duracion);
+    archivo.valor(config.max_procesos);
+    archivo.texto(config.politica);
+    archivo.texto(config.archivo_traza);
+    archivo.valor(config.modelo_carga);
+    archivo.valor(config.zipf_exponente);
+    archivo.valor(config.fraccion_ventana);
+    archivo.valor(config.accesos_por_deriva);
+    archivo.valor(config.accesos_por_fase);
+    archivo.texto(config.nivel_registro);
+    archivo.texto(config.archivo_registro_binario);
+    archivo.texto(config.archivo_registro);
+    archivo.texto(config.prefijo_metricas);
+    archivo.valor(config.intervalo_metricas);
+    archivo.texto(config.archivo_swap);
+    archivo.valor(config.lote_swap);
+    archivo.valor(config.hilos_es);
+    archivo.valor(config.swap_directo);
+    archivo.valor(config.cache_comprimida_mb);
+    archivo.valor(config.umbral_compresion);
+    archivo.valor(config.paginas_anticipacion);
+    archivo.texto(config.modo_anticipacion);
+    archivo.valor(config.marca_min);
+    archivo.valor(config.marca_baja);
+    archivo.valor(config.marca_alta);
+    archivo.valor(config.lote_recuperacion);
+    archivo.valor(config.intervalo_recuperacion);
+    archivo.valor(config.probabilidad_fork);
+    archivo.valor(config.paginas_biblioteca);
+    archivo.valor(config.fraccion_escrituras);
+    archivo.valor(config.paginas_ksm);
+    archivo.valor(config.intervalo_ksm);
+    archivo.valor(config.paginacion_demanda);
+    archivo.valor(config.paginas_enormes);
+    archivo.valor(config.regiones_promocion);
+    archivo.valor(config.intervalo_promocion);
+    archivo.valor(config.ventana_trabajo);
+    archivo.valor(config.control_carga);
+    archivo.valor(config.intervalo_control);
+    archivo.valor(config.costo_swap_us);
+    archivo.valor(config.factor_virtual);
+    archivo.texto(config.archivo_barrido);
+    archivo.valor(config.hilos);
+    archivo.texto(config.archivo_resultados);
+    archivo.texto(config.archivo_guardar_estado);
+    archivo.texto(config.archivo_restaurar_estado);
+    archivo.valor(config.modo_concurrente);
+    archivo.valor(config.accesos_por_proceso);
+    archivo.valor(config.tlb_entradas);
+    archivo.valor(config.tlb_vias);
+    archivo.valor(config.tlb_asid);
+    archivo.texto(config.tlb_reemplazo);
+}
+
+// Lee solo la configuración de un estado guardado, sin restaurar el simulador
+bool leerConfiguracionEstado(const string& ruta, ConfiguracionSimulacion& config, string& error) {
+    LectorEstado lector;
+    if (!lector.abrir(ruta, false)) {
+        error = lector.obtenerError();
+        return false;
+    }
+    serializarConfiguracion(lector, config);
+    if (!lector.valido()) {
+        error = lector.obtenerError();
+        return false;
+    }
+    return true;
+}
+
+// Opción que no puede cambiar al restaurar un estado ("" si no cambió ninguna): define
+// el tamaño de las estructuras guardadas o cómo se interpretan (el resto, como las
+// tasas o la duración, sí puede cambiar para la continuación)
+string opcionEstadoDistinta(const ConfiguracionSimulacion& guardada, const ConfiguracionSimulacion& config) {
+    if (config.memoria_fisica != guardada.memoria_fisica) return "--memoria";
+    if (config.tamano_pagina != guardada.tamano_pagina) return "--pagina";
+    if (config.factor_virtual != guardada.factor_virtual) return "--factor-virtual";
+    if (config.politica != guardada.politica) return "--politica";
+    if (config.modelo_carga != guardada.modelo_carga) return "--carga";
+    if (config.zipf_exponente != guardada.zipf_exponente) return "--zipf-exponente";
+    if (config.paginas_biblioteca != guardada.paginas_biblioteca) return "--biblioteca";
+    if (config.paginacion_demanda != guardada.paginacion_demanda) return "--demanda";
+    if (config.paginas_enormes != guardada.paginas_enormes) return "--paginas-enormes";
+    if (config.ventana_trabajo != guardada.ventana_trabajo) return "--conjunto-trabajo";
+    if (config.tlb_entradas != guardada.tlb_entradas) return "--tlb";
+    if (config.tlb_vias != guardada.tlb_vias) return "--tlb-vias";
+    if (config.tlb_asid != guardada.tlb_asid) return "--tlb-asid";
+    if (config.tlb_reemplazo != guardada.tlb_reemplazo) return "--tlb-reemplazo";
+    return "";
+}
+
+// ============================================================================
+// CLASE PRINCIPAL - SIMULADOR DE MEMORIA
+// ============================================================================
+
+template <class Politica>
+class SimuladorMemoria {
+private:
+    // Representación de la memoria
+    AsignadorMarcos marcos_ram;   // Marcos de RAM: ocupante -1 = libre, índice = página
+    AsignadorMarcos marcos_swap;  // Marcos de SWAP: ocupante -1 = libre, índice = página
+    Politica politica;            // Política de reemplazo (resuelta en compilación)
+    TLB tlb;                      // Traducciones recientes (inactiva si no se configuró)
+    
+    // Procesos y páginas vivos (las ranuras de los finalizados se reciclan)
+    AlmacenSlab<Proceso> procesos;          // Procesos activos
+    TablaPaginas paginas;                   // Páginas de los procesos activos
+    vector<ReferenciaSlab> procesos_activos; // Lista densa para elegir procesos en O(1)
+    
+    // Contadores y estado interno
+    int siguiente_pid;          // Siguiente ID disponible para procesos
+    int64_t siguiente_id_pagina; // Siguiente ID global para páginas
+    
+    // Estadísticas para reporte final
+    double memoria_virtual_mb;  // Memoria virtual total (RAM + SWAP) en MB
+    double factor_memoria_virtual; // Factor usado (el sorteado si la configuración dice 0)
+    double duracion_real;       // Segundos reales de la última ejecución
+    unsigned long long accesos_memoria; // Accesos a páginas atendidos
+    unsigned long long fallos_pagina; // Número total de fallos de página ocurridos
+    unsigned long long procesos_creados; // Número total de procesos creados
+    unsigned long long procesos_finalizados; // Número total de procesos finalizados
+    
+    // Generador de números aleatorios
+    mt19937 generador_aleatorio;
+    GeneradorCarga generador_carga;    // Modelo de accesos de los procesos
+    
+    // Salida de la simulación
+    Registro registro;                 // Texto por niveles y eventos binarios
+    Metricas metricas;                 // Contadores e histogramas mantenidos al vuelo
+    bool metricas_activas;             // Se configuró un prefijo de métricas
+    FILE* csv_metricas;                // Serie de tiempo de instantáneas (nullptr = no)
+    
+    // Modo contenido (solo si se configuró un archivo de SWAP)
+    unique_ptr<AlmacenSwap> almacen_swap; // Archivo de SWAP con lotes y E/S asíncrona
+    unique_ptr<CacheComprimida> cache_comprimida; // Páginas expulsadas comprimidas en RAM (usa almacen_swap)
+    BufferAlineado contenido_ram;      // Bytes de cada marco de RAM
+    BufferAlineado pagina_temporal;    // Página nueva que se crea directamente en SWAP
+    size_t bytes_pagina;               // Tamaño de página en bytes
+    unsigned long long errores_contenido; // Páginas leídas de SWAP con contenido incorrecto
+    
+    // Lectura anticipada (búferes reutilizados entre fallos)
+    vector<pair<int, int>> lote_anticipado;          // (página, ranura de SWAP) del lote en curso
+    vector<pair<int, uint8_t*>> pedidos_anticipados; // (ranura, destino) para el archivo de SWAP
+    vector<unique_ptr<SolicitudES>> lecturas_anticipadas;
+    
+    // Recuperación en segundo plano: marcas de marcos libres (marca_alta = 0: inactiva)
+    size_t marca_min;
+    size_t marca_baja;
+    size_t marca_alta;
+    bool recuperacion_pendiente;       // El reclamador ya tiene un despertar programado
+    
+    // Páginas compartidas: por cada página de la biblioteca común, una página que la mapea
+    // (-1 = ningún proceso vivo la tiene). Siempre es una página con ese mismo ID local.
+    vector<int> paginas_biblioteca;
+    
+    // Escáner de fusión (como KSM): próxima ranura de la tabla de páginas, suma de cada
+    // página en la pasada anterior (con su generación + 1, 0 = sin suma) y candidatas de
+    // esta pasada por suma (página y generación)
+    size_t cursor_ksm;
+    vector<pair<uint32_t, uint64_t>> sumas_ksm;
+    unordered_map<uint64_t, pair<int, uint32_t>> candidatas_ksm;
+    
+    // Promotor de páginas enormes (como khugepaged): posición en procesos_activos y
+    // próxima región a revisar de ese proceso
+    size_t cursor_promocion;
+    int64_t region_promocion;
+    
+    // Control de carga: procesos suspendidos (el más antiguo primero), llegadas que esperan
+    // lugar y, por ranura de página, el instante de su última referencia en el reloj
+    // virtual de su proceso (0 = sin referencias)
+    deque<ReferenciaSlab> procesos_suspendidos;
+    int llegadas_diferidas;
+    vector<int64_t> ultima_referencia;
+    
+    // Motor de eventos discretos (tiempo simulado, sin esperas reales)
+    ConfiguracionSimulacion config;    // Tasas de eventos y duración
+    priority_queue<Evento, vector<Evento>, greater<Evento>> cola_eventos; // Eventos pendientes
+    double tiempo_simulado;            // Reloj virtual en segundos
+    unsigned long long secuencia_eventos;  // Contador para desempatar eventos simultáneos
+    unsigned long long eventos_procesados; // Eventos atendidos en total
+    bool restaurado;                   // El estado viene de un archivo: no se programan los eventos iniciales
+
+public:
+    // Constructor principal - inicializa toda la simulación
+    explicit SimuladorMemoria(const ConfiguracionSimulacion& configuracion) 
+        : siguiente_pid(1),                  // Empezar PIDs desde 1
+          siguiente_id_pagina(1),            // Empezar IDs de páginas desde 1
+          memoria_virtual_mb(0.0),
+          factor_memoria_virtual(0.0),
+          duracion_real(0.0),
+          accesos_memoria(0),
+          fallos_pagina(0),                  // Contador de fallos de página en 0
+          procesos_creados(0),               // Contador de procesos creados en 0
+          procesos_finalizados(0),           // Contador de procesos finalizados en 0
+          generador_aleatorio(configuracion.semilla), // Misma semilla = misma simulación
+          generador_carga(configuracion),
+          registro(nivelRegistro(configuracion), configuracion.archivo_registro),
+          metricas_activas(!configuracion.prefijo_metricas.empty()),
+          csv_metricas(nullptr),
+          bytes_pagina(configuracion.tamano_pagina),
+          errores_contenido(0),
+          marca_min(0),
+          marca_baja(0),
+          marca_alta(0),
+          recuperacion_pendiente(false),
+          paginas_biblioteca(configuracion.paginas_biblioteca, -1),
+          cursor_ksm(0),
+          cursor_promocion(0),
+          region_promocion(0),
+          llegadas_diferidas(0),
+          config(configuracion),
+          tiempo_simulado(0.0),
+          secuencia_eventos(0),
+          eventos_procesados(0),
+          restaurado(false) {
+        
+        if (!config.archivo_registro_binario.empty() && !registro.abrirBinario(config.archivo_registro_binario)) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_ERROR << "No se pudo crear el registro binario "
+                      << config.archivo_registro_binario << COLOR_RESET << '\n');
+        }
+        if (metricas_activas) abrirMetricas();
+        inicializarMemoria(); // Inicializar la memoria del sistema
+    }
+    
+    ~SimuladorMemoria() {
+        if (csv_metricas != nullptr) fclose(csv_metricas);
+    }
+    
+    SimuladorMemoria(const SimuladorMemoria&) = delete;
+    SimuladorMemoria& operator=(const SimuladorMemoria&) = delete;
+
+    // Nivel de registro pedido en la configuración (detalle si el nombre no es válido)
+    static NivelRegistro nivelRegistro(const ConfiguracionSimulacion& configuracion) {
+        NivelRegistro nivel = NivelRegistro::DETALLE;
+        leerNivelRegistro(configuracion.nivel_registro, nivel);
+        return nivel;
+    }
+
+    // Inicializa la memoria física y virtual
+    void inicializarMemoria() {
+        // Calcular memoria virtual (entre 1.5 y 4.5 veces la física, o el factor configurado)
+        double factor = config.factor_virtual;
+        if (factor <= 0.0) {
+            uniform_real_distribution<double> distribucion_factor(1.5, 4.5);
+            factor = distribucion_factor(generador_aleatorio);
+        }
+        memoria_virtual_mb = config.memoria_fisica / 1048576.0 * factor;
+        factor_memoria_virtual = factor;
+        
+        // Calcular número de marcos
+        int64_t num_marcos_ram = config.memoria_fisica / bytes_pagina;            // Marcos en RAM
+        int64_t total_marcos = memoria_virtual_mb * 1048576.0 / bytes_pagina;     // Marcos totales (RAM + SWAP)
+        int64_t num_marcos_swap = total_marcos - num_marcos_ram;                  // Marcos en SWAP
+        
+        // Asegurar valores mínimos
+        if (num_marcos_ram <= 0) num_marcos_ram = 1;
+        if (num_marcos_swap <= 0) num_marcos_swap = total_marcos; // Asegurar suficiente swap
+        
+        // Inicializar vectores de memoria (todos libres inicialmente: -1)
+        marcos_ram.inicializar(num_marcos_ram, config.paginas_enormes); // Bloques alineados para páginas enormes
+        marcos_swap.inicializar(num_marcos_swap);
+        politica.inicializar(num_marcos_ram);
+        if (config.marca_alta > 0) {
+            auto marcos = [num_marcos_ram](double porcentaje) { return size_t(ceil(porcentaje * num_marcos_ram / 100.0)); };
+            marca_min = marcos(config.marca_min);
+            marca_baja = max(marca_min, marcos(config.marca_baja));
+            marca_alta = max(marca_baja, marcos(config.marca_alta));
+        }
+        if (!config.archivo_swap.empty()) abrirSwapArchivo(num_marcos_ram, num_marcos_swap);
+        tlb.inicializar(config.tlb_entradas, config.tlb_vias, config.tlb_asid, config.tlb_reemplazo == "lru");
+        if (config.paginas_enormes) tlb.habilitarEnormes();
+        
+        // Mostrar configuración inicial
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "=== CONFIGURACIÓN INICIAL ===" << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Memoria Física: " << textoTamano(config.memoria_fisica) << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Memoria Virtual: " << memoria_virtual_mb << " MB" << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Tamaño Página: " << textoTamano(bytes_pagina) << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Marcos RAM: " << num_marcos_ram << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Marcos SWAP: " << num_marcos_swap << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Política de reemplazo: " << Politica::nombre() << COLOR_RESET << '\n');
+        if (tlb.activa()) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "TLB: " << tlb.numEntradas() << " entradas, "
+                 << tlb.numVias() << " vías, " << config.tlb_reemplazo << ", "
+                 << (tlb.usaAsid() ? "con ASID" : "sin ASID (vaciado al cambiar de proceso)") << COLOR_RESET << '\n');
+        }
+        if (cache_comprimida) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Caché comprimida: " << config.cache_comprimida_mb
+                 << " MB, acepta páginas comprimidas hasta " << config.umbral_compresion * 100 << "% de la página" << COLOR_RESET << '\n');
+        }
+        if (marca_alta > 0) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Recuperación en segundo plano: marcas de marcos libres min/baja/alta "
+                 << marca_min << "/" << marca_baja << "/" << marca_alta << ", hasta " << config.lote_recuperacion
+                 << " páginas cada " << config.intervalo_recuperacion << " s" << COLOR_RESET << '\n');
+        }
+        if (config.probabilidad_fork > 0 || config.paginas_biblioteca > 0 || config.fraccion_escrituras > 0) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Páginas compartidas: fork en " << config.probabilidad_fork * 100
+                 << "% de las llegadas, biblioteca común de " << config.paginas_biblioteca << " páginas, "
+                 << config.fraccion_escrituras * 100 << "% de escrituras sintéticas (copia en escritura)" << COLOR_RESET << '\n');
+        }
+        if (fusionActiva()) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Fusión de páginas iguales (KSM): " << config.paginas_ksm
+                 << " páginas cada " << config.intervalo_ksm << " s" << COLOR_RESET << '\n');
+        }
+        if (config.paginas_anticipacion > 0) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Lectura anticipada: hasta " << config.paginas_anticipacion
+                 << " páginas por fallo (" << config.modo_anticipacion << ", ventana adaptativa)" << COLOR_RESET << '\n');
+        }
+        if (config.paginacion_demanda) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Paginación por demanda: cada página se crea en su primer acceso "
+                 << "(sin reservar memoria al crear el proceso)" << COLOR_RESET << '\n');
+        }
+        if (config.paginas_enormes) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Páginas enormes: " << textoTamano(PAGINAS_ENORME * bytes_pagina)
+                 << " (" << PAGINAS_ENORME << " páginas), " << marcos_ram.total() / PAGINAS_ENORME << " bloques de RAM, promotor: "
+                 << config.regiones_promocion << " regiones cada " << config.intervalo_promocion << " s" << COLOR_RESET << '\n');
+        }
+        if (config.ventana_trabajo > 0) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Control de carga: conjunto de trabajo de las últimas "
+                 << config.ventana_trabajo << " referencias de cada proceso, revisado cada " << config.intervalo_control << " s"
+                 << (config.control_carga ? "" : " (solo medición)") << COLOR_RESET << '\n');
+        }
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Semilla: " << config.semilla << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "=============================" << COLOR_RESET << '\n');
+    }
+
+    // Modo contenido: reserva los bytes de la RAM y crea el archivo de SWAP
+    void abrirSwapArchivo(size_t num_marcos_ram, size_t num_marcos_swap) {
+        string error;
+        almacen_swap.reset(new AlmacenSwap());
+        if (!contenido_ram.reservar(num_marcos_ram * bytes_pagina) || !pagina_temporal.reservar(bytes_pagina)) {
+            error = "Sin memoria para el contenido de la RAM";
+        } else {
+            almacen_swap->abrir(config.archivo_swap, num_marcos_swap, bytes_pagina, config.lote_swap,
+                                config.hilos_es, config.swap_directo, error);
+        }
+        if (!error.empty()) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_ERROR << error << " (se continúa sin contenido)" << COLOR_RESET << '\n');
+            almacen_swap.reset();
+            return;
+        }
+        if (config.cache_comprimida_mb > 0) {
+            cache_comprimida.reset(new CacheComprimida(*almacen_swap, num_marcos_swap, bytes_pagina,
+                                                       size_t(config.cache_comprimida_mb) << 20, config.umbral_compresion));
+            if (!cache_comprimida->abrir()) {
+                REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_ERROR << "Sin memoria para la caché comprimida (se continúa sin ella)"
+                     << COLOR_RESET << '\n');
+                cache_comprimida.reset();
+            }
+        }
+    }
+    
+    // Guarda una página que va a SWAP: en la caché comprimida si la acepta, si no en el archivo
+    void guardarEnSwap(int ranura, const uint8_t* contenido) {
+        if (!cache_comprimida || !cache_comprimida->guardar(ranura, contenido)) almacen_swap->escribir(ranura, contenido);
+    }
+    
+    // Inicia el swap-in de una ranura: desde la caché comprimida (ya copiada, nullptr)
+    // o desde el archivo (solicitud a esperar)
+    unique_ptr<SolicitudES> leerDeSwap(int ranura, uint8_t* destino) {
+        if (cache_comprimida && cache_comprimida->cargar(ranura, destino)) return nullptr;
+        return almacen_swap->leer(ranura, destino);
+    }
+    
+    // La ranura de SWAP quedó libre: se descarta su copia en la caché o en un lote
+    void liberarRanura(int ranura) {
+        if (cache_comprimida) cache_comprimida->liberar(ranura);
+        almacen_swap->liberar(ranura);
+    }
+    
+    // Bytes del marco de RAM
+    uint8_t* contenidoMarco(int marco) { return contenido_ram.obtener() + size_t(marco) * bytes_pagina; }
+    
+    // ID del contenido inicial de una página nueva. Como en una memoria real hay páginas
+    // repetidas: una de cada cuatro es una página de ceros (contenido 0) y una de cada
+    // ocho repite uno de 64 textos; el resto tiene contenido propio (su ID global).
+    static int64_t contenidoInicial(int64_t id_global) {
+        if (id_global % 4 == 0) return 0;
+        if (id_global % 8 == 1) return 1 + 8 * ((id_global / 8) % 64);
+        return id_global;
+    }
+    
+    // Contenido inicial de una página, generado a partir de su ID de contenido. Según el
+    // ID la página es de ceros, texto de un vocabulario pequeño o bytes aleatorios, así
+    // la caché comprimida ve páginas con distinta compresibilidad. Lleva el ID, un
+    // contador de escrituras y el ID en el último byte, para verificar que vuelve
+    // intacta de SWAP.
+    void inicializarContenido(uint8_t* destino, int64_t id_contenido) {
+        static const char vocabulario[16][9] = {
+            "memoria ", "pagina  ", "proceso ", "marco   ", "swap    ", "fallo   ", "tabla   ", "acceso  ",
+            "datos   ", "valor   ", "indice  ", "lectura ", "bloque  ", "archivo ", "sistema ", "cache   "
+        };
+        uint64_t estado = static_cast<uint64_t>(id_contenido) * 0x9E3779B97F4A7C15ULL + 1;
+        auto aleatorio = [&estado]() { // xorshift64
+            estado ^= estado << 13;
+            estado ^= estado >> 7;
+            estado ^= estado << 17;
+            return estado;
+        };
+        switch (id_contenido % 4) {
+            case 0:
+                memset(destino, id_contenido & 0xff, bytes_pagina);
+                break;
+            case 3:
+                for (size_t i = 0; i + 8 <= bytes_pagina; i += 8) {
+                    uint64_t valor = aleatorio();
+                    memcpy(destino + i, &valor, sizeof(valor));
+                }
+                break;
+            default: {
+                uint64_t bits = 0;
+                for (size_t i = 0, restantes = 0; i + 8 <= bytes_pagina; i += 8, bits >>= 4, restantes--) {
+                    if (restantes == 0) {
+                        bits = aleatorio();
+                        restantes = 16;
+                    }
+                    memcpy(destino + i, vocabulario[bits & 15], 8);
+                }
+            }
+        }
+        destino[bytes_pagina - 1] = id_contenido & 0xff;
+        uint64_t identificador = id_contenido, escrituras = 0;
+        memcpy(destino, &identificador, sizeof(identificador));
+        memcpy(destino + sizeof(identificador), &escrituras, sizeof(escrituras));
+    }
+    
+    bool verificarContenido(const uint8_t* contenido, int64_t id_contenido) const {
+        uint64_t identificador;
+        memcpy(&identificador, contenido, sizeof(identificador));
+        return identificador == static_cast<uint64_t>(id_contenido) && contenido[bytes_pagina - 1] == (id_contenido & 0xff);
+    }
+    
+    // Una escritura del proceso modifica la página (incrementa su contador)
+    void escribirContenido(uint8_t* contenido) {
+        uint64_t escrituras;
+        memcpy(&escrituras, contenido + sizeof(uint64_t), sizeof(escrituras));
+        escrituras++;
+        memcpy(contenido + sizeof(uint64_t), &escrituras, sizeof(escrituras));
+    }
+
+    // Pide a la política de reemplazo el marco a desalojar (saltando marco_excluido) y
+    // retorna su página
+    int elegirPaginaVictima(int marco_excluido = -1) {
+        int marco = politica.elegirVictima(marco_excluido);
+        if (marco == -1) return -1; // No hay páginas en RAM
+        return marcos_ram.ocupante(marco);
+    }
+
+    // Política en uso (por ejemplo, para entregarle el futuro a OPT)
+    Politica& obtenerPolitica() { return politica; }
+    
+    // Proceso de una ranura y cantidad de procesos activos (para los benchmarks)
+    Proceso& obtenerProceso(int indice_proceso) { return procesos[indice_proceso]; }
+    size_t numProcesosActivos() const { return procesos_activos.size(); }
+
+    // Crea un nuevo proceso con tamaño aleatorio
+    bool crearProceso() {
+        // Generar tamaño aleatorio del proceso dentro del rango especificado
+        uint64_t tamano_proceso = sortearTamanoProceso(config, generador_aleatorio);
+        int64_t num_paginas = (tamano_proceso + bytes_pagina - 1) / bytes_pagina;
+        if (config.probabilidad_fork > 0 && !procesos_activos.empty()) {
+            bernoulli_distribution distribucion_fork(config.probabilidad_fork);
+            if (distribucion_fork(generador_aleatorio)) {
+                ReferenciaSlab padre;
+                elegirProcesoActivo(&padre);
+                return forkProceso(padre.indice) != -1;
+            }
+        }
+        return crearProcesoConPaginas(tamano_proceso, num_paginas) != -1;
+    }
+
+    // Crea un proceso del tamaño indicado; retorna su ranura o -1 si no hay memoria
+    int crearProcesoConPaginas(uint64_t tamano_proceso, int64_t num_paginas) {
+        int pid = siguiente_pid++;
+        
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[CREACIÓN] Proceso PID=" << pid 
+             << " (" << textoTamano(tamano_proceso) << ", " << num_paginas << " páginas)" << COLOR_RESET << '\n');
+        
+        // Verificar si hay suficiente memoria total (RAM + SWAP) para las páginas propias:
+        // las de la biblioteca que ya mapea otro proceso se comparten y no ocupan marcos.
+        // Con paginación por demanda no se reserva nada (sobrecompromiso, como Linux).
+        size_t num_biblioteca = min<uint64_t>(num_paginas, paginas_biblioteca.size());
+        if (!config.paginacion_demanda) {
+            size_t ram_libre = marcos_ram.libres();
+            size_t swap_libre = marcos_swap.libres();
+            size_t compartidas = count_if(paginas_biblioteca.begin(), paginas_biblioteca.begin() + num_biblioteca,
+                                          [](int indice) { return indice != -1; });
+            
+            if (ram_libre + swap_libre < num_paginas - compartidas) {
+                REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "[ERROR] Memoria insuficiente para proceso PID=" 
+                     << pid << COLOR_RESET << '\n');
+                return -1;
+            }
+        }
+        
+        // Crear nuevo proceso (su ranura es el dueño de sus páginas)
+        int indice_proceso = procesos.crear(Proceso(pid, tamano_proceso, num_paginas));
+        Proceso& nuevo_proceso = procesos[indice_proceso];
+        sumarNodos(nuevo_proceso.tabla.numNodos());
+        generador_carga.inicializarEstado(nuevo_proceso.carga, num_paginas, generador_aleatorio);
+        
+        // Asignar páginas del proceso (con paginación por demanda se crean al tocarlas)
+        for (int64_t i = 0; i < num_paginas && !config.paginacion_demanda; ++i) {
+            // Región alineada completa: se intenta mapear entera como página enorme
+            if (i % PAGINAS_ENORME == 0 && regionApta(nuevo_proceso, i >> BITS_ENORME) &&
+                mapearRegionEnorme(indice_proceso, i >> BITS_ENORME)) {
+                i += PAGINAS_ENORME - 1;
+                continue;
+            }
+            int indice_pagina = crearPagina(indice_proceso, i);
+            
+            // Página de la biblioteca común: se comparte si otro proceso ya la tiene
+            if (size_t(i) < num_biblioteca) {
+                if (paginas_biblioteca[i] != -1) {
+                    compartirPagina(nuevo_proceso, indice_pagina, paginas_biblioteca[i]);
+                    continue;
+                }
+                paginas_biblioteca[i] = indice_pagina;
+            }
+            
+            // Intentar cargar en RAM primero (política de asignación)
+            int marco_libre = obtenerMarcoLibre(indice_pagina);
+            if (marco_libre != -1) {
+                // Hay espacio en RAM
+                paginas.moverARam(indice_pagina, marco_libre);
+                nuevo_proceso.paginas_residentes++;
+                if (almacen_swap) inicializarContenido(contenidoMarco(marco_libre), paginas.idContenido(indice_pagina));
+                politica.alCargar(marco_libre, clavePagina(pid, i));
+                REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Página " << paginas.idGlobal(indice_pagina) 
+                     << " (PID=" << pid << "-" << i 
+                     << ") cargada en RAM (marco " << marco_libre << ")" << COLOR_RESET << '\n');
+            } else {
+                // RAM llena, usar SWAP (hay espacio: se verificó antes)
+                marco_libre = marcos_swap.asignar(indice_pagina);
+                paginas.moverASwap(indice_pagina, marco_libre);
+                if (almacen_swap) {
+                    inicializarContenido(pagina_temporal.obtener(), paginas.idContenido(indice_pagina));
+                    guardarEnSwap(marco_libre, pagina_temporal.obtener());
+                }
+                REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_SWAP << "  → Página " << paginas.idGlobal(indice_pagina) 
+                     << " (PID=" << pid << "-" << i 
+                     << ") asignada a SWAP (marco " << marco_libre << ")" << COLOR_RESET << '\n');
+            }
+        }
+        
+        activarProceso(indice_proceso);
+        return indice_proceso;
+    }
+    
+    // Crea la página virtual del proceso en la tabla global y la mapea en su tabla radix.
+    // Sin numerar, la página aún no recibe ID global ni contenido: el primer toque la
+    // numera recién cuando sabe que puede ubicarla.
+    int crearPagina(int indice_proceso, int64_t pagina, bool numerar = true) {
+        int indice_pagina = paginas.crear(indice_proceso, pagina, 0);
+        if (numerar) numerarPagina(indice_pagina);
+        if (size_t(indice_pagina) < ultima_referencia.size()) ultima_referencia[indice_pagina] = 0;
+        Proceso& proceso = procesos[indice_proceso];
+        size_t nodos = proceso.tabla.numNodos();
+        proceso.tabla.mapear(pagina, indice_pagina);
+        proceso.paginas_mapeadas++;
+        sumarNodos(proceso.tabla.numNodos() - nodos);
+        return indice_pagina;
+    }
+    
+    // Da a la página el siguiente ID global y el contenido inicial que le corresponde
+    void numerarPagina(int indice_pagina) {
+        paginas.asignarIdGlobal(indice_pagina, siguiente_id_pagina++);
+        paginas.asignarContenido(indice_pagina, contenidoInicial(paginas.idGlobal(indice_pagina)));
+    }
+    
+    // Nodos radix creados (se restan al finalizar el proceso)
+    void sumarNodos(size_t nodos) {
+        metricas.nodos_tabla += nodos;
+        metricas.nodos_tabla_pico = max(metricas.nodos_tabla_pico, metricas.nodos_tabla);
+    }
+    
+    // Región que puede ser página enorme: completa dentro del proceso y fuera de la
+    // biblioteca común (cuyas páginas se comparten una por una)
+    bool regionApta(const Proceso& proceso, int64_t region) const {
+        return config.paginas_enormes && (region + 1) * PAGINAS_ENORME <= proceso.num_paginas &&
+               region * PAGINAS_ENORME >= static_cast<int64_t>(paginas_biblioteca.size());
+    }
+    
+    // Mapea una región completa del proceso como página enorme: crea sus PAGINAS_ENORME
+    // páginas de una vez en un bloque alineado de marcos. Retorna false si no hay bloque
+    // libre o si tomarlo dejaría menos libres que la marca mínima.
+    bool mapearRegionEnorme(int indice_proceso, int64_t region) {
+        if (!marcos_ram.hayBloqueLibre() || marcos_ram.libres() < marca_min + PAGINAS_ENORME) return false;
+        int64_t primera = region << BITS_ENORME;
+        for (int i = 0; i < PAGINAS_ENORME; ++i) crearPagina(indice_proceso, primera + i);
+        Proceso& proceso = procesos[indice_proceso];
+        const int* ranuras = proceso.tabla.region(region);
+        int primer_marco = marcos_ram.asignarBloque(ranuras);
+        for (int i = 0; i < PAGINAS_ENORME; ++i) {
+            paginas.moverARam(ranuras[i], primer_marco + i);
+            paginas.marcarEnorme(ranuras[i], true);
+            proceso.paginas_residentes++;
+            if (almacen_swap) inicializarContenido(contenidoMarco(primer_marco + i), paginas.idContenido(ranuras[i]));
+            politica.alCargar(primer_marco + i, clavePagina(proceso.pid, primera + i));
+        }
+        proceso.tabla.marcarEnorme(region, true);
+        metricas.regiones_enormes++;
+        metricas.enormes_mapeadas++;
+        registro.binario(TipoEventoBinario::ENORME, tiempo_simulado, proceso.pid, primera, primer_marco);
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Región " << region << " (PID=" << proceso.pid
+             << ", páginas " << primera << "-" << primera + PAGINAS_ENORME - 1 << ") mapeada como página enorme (marcos "
+             << primer_marco << "-" << primer_marco + PAGINAS_ENORME - 1 << ")" << COLOR_RESET << '\n');
+        despertarRecuperacion();
+        return true;
+    }
+    
+    // Divide una página enorme en páginas base (antes de expulsar o compartir una de sus
+    // páginas): los marcos no se mueven, solo se pierde la traducción única
+    void dividirRegion(Proceso& proceso, int64_t region) {
+        const int* ranuras = proceso.tabla.region(region);
+        for (int i = 0; i < PAGINAS_ENORME; ++i) paginas.marcarEnorme(ranuras[i], false);
+        proceso.tabla.marcarEnorme(region, false);
+        if (tlb.activa()) tlb.invalidarEnorme(proceso.pid, region);
+        metricas.regiones_enormes--;
+        metricas.enormes_divididas++;
+        registro.binario(TipoEventoBinario::DIVISION, tiempo_simulado, proceso.pid, region << BITS_ENORME, -1);
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_INFO << "  → Página enorme de la región " << region << " (PID="
+             << proceso.pid << ") dividida en páginas base" << COLOR_RESET << '\n');
+    }
+    
+    // Crea un proceso como fork de otro: el hijo comparte todas las páginas del padre con
+    // copia en escritura, así no necesita marcos hasta que alguno de los dos escriba.
+    // Retorna la ranura del hijo.
+    int forkProceso(int indice_padre) {
+        int pid = siguiente_pid++;
+        int pid_padre = procesos[indice_padre].pid;
+        int64_t num_paginas = procesos[indice_padre].num_paginas;
+        
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[FORK] Proceso PID=" << pid << " hijo de PID="
+             << pid_padre << " (" << procesos[indice_padre].paginas_mapeadas
+             << " páginas compartidas con copia en escritura)" << COLOR_RESET << '\n');
+        
+        // Las páginas enormes del padre se dividen: el hijo comparte páginas base
+        if (metricas.regiones_enormes > 0) dividirEnormes(procesos[indice_padre]);
+        
+        int indice_proceso = procesos.crear(Proceso(pid, procesos[indice_padre].tamano, num_paginas));
+        Proceso& padre = procesos[indice_padre];
+        Proceso& hijo = procesos[indice_proceso];
+        hijo.carga = padre.carga;
+        sumarNodos(hijo.tabla.numNodos());
+        padre.tabla.recorrer([&](int64_t pagina, int indice_original) {
+            int indice_pagina = crearPagina(indice_proceso, pagina);
+            compartirPagina(hijo, indice_pagina, indice_original);
+            return true;
+        });
+        
+        // Las páginas del padre quedan protegidas contra escritura: sus traducciones se descartan
+        if (tlb.activa()) tlb.invalidarProceso(pid_padre);
+        metricas.forks++;
+        activarProceso(indice_proceso);
+        return indice_proceso;
+    }
+    
+    // Divide todas las páginas enormes del proceso
+    void dividirEnormes(Proceso& proceso) {
+        for (int64_t region = proceso.tabla.siguienteRegion(0); region != -1;
+             region = proceso.tabla.siguienteRegion(region + 1)) {
+            if (proceso.tabla.enorme(region)) dividirRegion(proceso, region);
+        }
+    }
+    
+    // Agrega un proceso recién creado a la lista de activos
+    void activarProceso(int indice_proceso) {
+        Proceso& proceso = procesos[indice_proceso];
+        agregarAActivos(indice_proceso);
+        procesos_creados++;
+        registro.binario(TipoEventoBinario::CREACION, tiempo_simulado, proceso.pid, proceso.num_paginas, -1);
+    }
+    
+    // Pone el proceso al final de la lista de activos
+    void agregarAActivos(int indice_proceso) {
+        procesos[indice_proceso].posicion_activa = procesos_activos.size();
+        procesos_activos.push_back(procesos.referencia(indice_proceso));
+    }
+    
+    // Quita el proceso de la lista de activos (el último ocupa su lugar)
+    void quitarDeActivos(Proceso& proceso) {
+        int posicion = proceso.posicion_activa;
+        procesos_activos[posicion] = procesos_activos.back();
+        procesos[procesos_activos[posicion].indice].posicion_activa = posicion;
+        procesos_activos.pop_back();
+        proceso.posicion_activa = -1;
+    }
+    
+    // La página nueva del proceso usa el marco o la ranura de otra página (fork o biblioteca)
+    void compartirPagina(Proceso& proceso, int indice_pagina, int otra) {
+        paginas.compartirCon(indice_pagina, otra);
+        if (paginas.enRam(indice_pagina)) proceso.paginas_residentes++;
+        sumarCompartida();
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_INFO << "  → Página " << paginas.idGlobal(indice_pagina)
+             << " (PID=" << proceso.pid << "-" << paginas.idPagina(indice_pagina) << ") comparte el "
+             << (paginas.enRam(indice_pagina) ? "marco de RAM " : "marco de SWAP ") << paginas.ubicacion(indice_pagina)
+             << " de la página " << paginas.idGlobal(otra) << COLOR_RESET << '\n');
+    }
+    
+    // Una página más usa el marco de otra (un marco ahorrado)
+    void sumarCompartida() {
+        metricas.paginas_compartidas++;
+        metricas.compartidas_pico = max(metricas.compartidas_pico, metricas.paginas_compartidas);
+    }
+    
+    // Saca una página compartida de su anillo (se libera o se copia al escribirla). Si
+    // ocupaba el marco o la ranura en los asignadores, la reemplaza otra del anillo.
+    void separarCompartida(int indice_pagina) {
+        int ubicacion = paginas.ubicacion(indice_pagina);
+        AsignadorMarcos& marcos = paginas.enRam(indice_pagina) ? marcos_ram : marcos_swap;
+        int restante = paginas.separar(indice_pagina);
+        if (marcos.ocupante(ubicacion) == indice_pagina) marcos.reasignar(ubicacion, restante);
+        soltarBiblioteca(indice_pagina, restante);
+        metricas.paginas_compartidas--;
+    }
+    
+    // La página deja de representar a su página de la biblioteca (se libera, se escribe o
+    // se copia): toma su lugar otra página del anillo con el mismo ID local, o ninguna
+    void soltarBiblioteca(int indice_pagina, int restante) {
+        if (paginas_biblioteca.empty()) return;
+        int64_t id = paginas.idPagina(indice_pagina);
+        if (size_t(id) >= paginas_biblioteca.size() || paginas_biblioteca[id] != indice_pagina) return;
+        int reemplazo = -1;
+        if (restante != -1) {
+            int otra = restante;
+            do {
+                if (paginas.idPagina(otra) == id) reemplazo = otra;
+                otra = paginas.siguienteCompartida(otra);
+            } while (otra != restante && reemplazo == -1);
+        }
+        paginas_biblioteca[id] = reemplazo;
+    }
+
+    // Elige un proceso activo al azar (nullptr si no hay)
+    Proceso* elegirProcesoActivo(ReferenciaSlab* referencia = nullptr) {
+        if (procesos_activos.empty()) return nullptr;
+        uniform_int_distribution<size_t> distribucion(0, procesos_activos.size() - 1);
+        ReferenciaSlab ref = procesos_activos[distribucion(generador_aleatorio)];
+        if (referencia) *referencia = ref;
+        return procesos.obtener(ref); // La generación detecta referencias obsoletas
+    }
+
+    // Finaliza un proceso aleatorio y libera su memoria
+    void finalizarProcesoAleatorio() {
+        // Seleccionar proceso aleatorio para finalizar
+        ReferenciaSlab ref_proceso;
+        Proceso* seleccionado = elegirProcesoActivo(&ref_proceso);
+        if (seleccionado == nullptr) {
+            REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[FINALIZACIÓN] No hay procesos activos" << COLOR_RESET << '\n');
+            return;
+        }
+        finalizarProceso(ref_proceso.indice);
+    }
+
+    // Finaliza el proceso de la ranura indicada y libera toda su memoria
+    void finalizarProceso(int indice_proceso) {
+        Proceso& proceso = procesos[indice_proceso];
+        
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[FINALIZACIÓN] Terminando proceso PID=" 
+             << proceso.pid << COLOR_RESET << '\n');
+        
+        // Sus traducciones dejan de ser válidas
+        if (tlb.activa()) tlb.invalidarProceso(proceso.pid);
+        
+        // Liberar todas las páginas del proceso
+        proceso.tabla.recorrer([&](int64_t pagina, int indice_pagina) {
+            int ubicacion = paginas.ubicacion(indice_pagina);
+            if (paginas.enorme(indice_pagina) && pagina % PAGINAS_ENORME == 0) metricas.regiones_enormes--;
+            if (paginas.compartida(indice_pagina)) {
+                // Otros procesos siguen usando el marco o la ranura: solo se sale del anillo
+                separarCompartida(indice_pagina);
+                REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_INFO << "  → Página " << paginas.idGlobal(indice_pagina)
+                     << " (PID=" << proceso.pid << "-" << paginas.idPagina(indice_pagina) << ") deja de compartir el "
+                     << (paginas.enRam(indice_pagina) ? "marco de RAM " : "marco de SWAP ") << ubicacion << COLOR_RESET << '\n');
+            } else if (paginas.enRam(indice_pagina)) {
+                if (paginas.anticipada(indice_pagina)) metricas.anticipadas_sin_uso++;
+                marcos_ram.liberar(ubicacion); // Liberar marco en RAM
+                politica.alLiberar(ubicacion, clavePagina(proceso.pid, paginas.idPagina(indice_pagina)));
+                REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Liberada página " << paginas.idGlobal(indice_pagina) 
+                     << " (PID=" << proceso.pid << "-" << paginas.idPagina(indice_pagina) 
+                     << ") de RAM (marco " << ubicacion << ")" << COLOR_RESET << '\n');
+            } else {
+                marcos_swap.liberar(ubicacion); // Liberar marco en SWAP
+                if (almacen_swap) liberarRanura(ubicacion);
+                REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_SWAP << "  → Liberada página " << paginas.idGlobal(indice_pagina) 
+                     << " (PID=" << proceso.pid << "-" << paginas.idPagina(indice_pagina) 
+                     << ") de SWAP (marco " << ubicacion << ")" << COLOR_RESET << '\n');
+            }
+            // Reciclar la ranura de la página
+            soltarBiblioteca(indice_pagina, -1);
+            paginas.liberar(indice_pagina);
+            return true;
+        });
+        
+        // Quitar de la lista de activos y reciclar la ranura
+        quitarDeActivos(proceso);
+        
+        registro.binario(TipoEventoBinario::FINALIZACION, tiempo_simulado, proceso.pid, -1, -1);
+        proceso.activo = false;
+        metricas.nodos_tabla -= proceso.tabla.numNodos();
+        proceso.tabla.liberar();
+        vector<int>().swap(proceso.referencias_recientes);
+        procesos.liberar(indice_proceso);
+        procesos_finalizados++;
+    }
+
+    // Simulamos un acceso a memoria (puede causar fallo de página)
+    bool simularAccesoMemoria() {
+        if (procesos_activos.empty()) {
+            REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[ACCESO] No hay procesos activos" << COLOR_RESET << '\n');
+            return true;
+        }
+        
+        // Modelos de localidad: proceso al azar y página según su modelo de acceso
+        if (generador_carga.obtenerModelo() != ModeloCarga::FORZADO) {
+            Proceso* proceso = elegirProcesoActivo();
+            int64_t pagina = generador_carga.siguientePagina(proceso->carga, proceso->num_paginas, generador_aleatorio);
+            return accederPagina(*proceso, pagina, sortearEscritura());
+        }
+        
+        // Modelo forzado: buscamos específicamente páginas en SWAP para forzar fallos de página
+        Proceso* elegido = nullptr;
+        int64_t pagina_acceder = -1;
+        
+        // Primero buscar procesos con páginas en SWAP
+        for (ReferenciaSlab ref : procesos_activos) {
+            Proceso& p = procesos[ref.indice];
+            p.tabla.recorrer([&](int64_t pagina, int indice_pagina) {
+                if (paginas.enRam(indice_pagina)) return true;
+                elegido = &p;
+                pagina_acceder = pagina;
+                return false;
+            });
+            if (elegido != nullptr) break;
+        }
+        
+        // Si no hay páginas en swap, elegir proceso y página aleatoria
+        if (elegido == nullptr) {
+            elegido = elegirProcesoActivo();
+            pagina_acceder = enteroUniforme(0, elegido->num_paginas - 1, generador_aleatorio);
+        }
+        
+        return accederPagina(*elegido, pagina_acceder, sortearEscritura());
+    }
+    
+    // Si el acceso sintético es una escritura (solo se sortea con una fracción configurada)
+    bool sortearEscritura() {
+        if (config.fraccion_escrituras <= 0) return false;
+        bernoulli_distribution distribucion_escritura(config.fraccion_escrituras);
+        return distribucion_escritura(generador_aleatorio);
+    }
+
+    // Marco libre de RAM para una página (-1 si no hay). Con el reclamador activo la
+    // asignación no baja de la marca mínima (bajo ella el fallo debe recuperar en línea),
+    // salvo que SWAP esté lleno y no se pueda expulsar, y si deja menos libres que la
+    // marca baja lo despierta.
+    int obtenerMarcoLibre(int indice_pagina) {
+        if (marca_alta == 0) return marcos_ram.asignar(indice_pagina);
+        bool reserva = marcos_ram.libres() <= marca_min && marcos_swap.libres() > 0;
+        int marco = reserva ? -1 : marcos_ram.asignar(indice_pagina);
+        despertarRecuperacion();
+        return marco;
+    }
+    
+    // Conjunto de trabajo: la referencia entra al anillo de las últimas ventana_trabajo
+    // referencias del proceso y la que sale deja el conjunto si su página no se volvió a
+    // referenciar después. Cada ranura de página recuerda el instante de su última
+    // referencia, así cada acceso actualiza el tamaño en O(1).
+    void registrarReferencia(Proceso& proceso, int indice_pagina) {
+        int64_t ventana = config.ventana_trabajo;
+        if (proceso.referencias_recientes.empty()) proceso.referencias_recientes.assign(ventana, -1);
+        if (ultima_referencia.size() < paginas.capacidad()) ultima_referencia.resize(paginas.capacidad(), 0);
+        int64_t ahora = ++proceso.tiempo_virtual;
+        int& saliente = proceso.referencias_recientes[ahora % ventana];
+        if (saliente != -1 && ultima_referencia[saliente] == ahora - ventana) proceso.conjunto_trabajo--;
+        int64_t anterior = ultima_referencia[indice_pagina];
+        if (anterior == 0 || anterior <= ahora - ventana) proceso.conjunto_trabajo++;
+        saliente = indice_pagina;
+        ultima_referencia[indice_pagina] = ahora;
+    }
+    
+    // Marcos que piden los conjuntos de trabajo de los procesos activos
+    int64_t demandaTrabajo() const {
+        int64_t demanda = 0;
+        for (ReferenciaSlab ref : procesos_activos) demanda += procesos[ref.indice].conjunto_trabajo;
+        return demanda;
+    }
+    
+    // Conjunto de trabajo que se espera de un proceso nuevo: el promedio de los activos
+    int64_t demandaLlegada(int64_t demanda) const {
+        return procesos_activos.empty() ? 0 : demanda / static_cast<int64_t>(procesos_activos.size());
+    }
+    
+    // Con el control de carga, una llegada espera si hay procesos suspendidos u otras
+    // llegadas esperando, o si su conjunto de trabajo estimado no cabe en la RAM
+    bool diferirLlegada() const {
+        if (config.ventana_trabajo == 0 || !config.control_carga) return false;
+        if (!procesos_suspendidos.empty() || llegadas_diferidas > 0) return true;
+        int64_t demanda = demandaTrabajo();
+        return demanda + demandaLlegada(demanda) > static_cast<int64_t>(marcos_ram.total());
+    }
+    
+    // Control de carga (planificador de mediano plazo): si la suma de los conjuntos de
+    // trabajo no cabe en la RAM el sistema está en hiperpaginación y se suspende el
+    // proceso de mayor conjunto de trabajo hasta que quepa (nunca el último activo).
+    // Después se reanudan los suspendidos, el más antiguo primero, mientras su conjunto
+    // de trabajo quepa, y por último se admiten las llegadas diferidas.
+    void atenderControlCarga() {
+        int64_t capacidad = marcos_ram.total();
+        int64_t demanda = demandaTrabajo();
+        metricas.revisiones_control++;
+        metricas.demanda_trabajo = demanda;
+        metricas.demanda_pico = max(metricas.demanda_pico, metricas.demanda_trabajo);
+        if (demanda > capacidad) metricas.sobrecargas++;
+        if (config.control_carga) {
+            while (demanda > capacidad && procesos_activos.size() > 1) {
+                size_t mayor = 0;
+                for (size_t i = 1; i < procesos_activos.size(); ++i) {
+                    if (procesos[procesos_activos[i].indice].conjunto_trabajo >
+                        procesos[procesos_activos[mayor].indice].conjunto_trabajo) mayor = i;
+                }
+                int indice_proceso = procesos_activos[mayor].indice;
+                demanda -= procesos[indice_proceso].conjunto_trabajo;
+                suspenderProceso(indice_proceso);
+            }
+            while (!procesos_suspendidos.empty()) {
+                int conjunto = procesos[procesos_suspendidos.front().indice].conjunto_trabajo;
+                if (!procesos_activos.empty() && demanda + conjunto > capacidad) break;
+                demanda += conjunto;
+                reanudarProceso();
+            }
+            while (llegadas_diferidas > 0 && procesos_suspendidos.empty() &&
+                   (procesos_activos.empty() || demanda + demandaLlegada(demanda) <= capacidad)) {
+                demanda += demandaLlegada(demanda);
+                llegadas_diferidas--;
+                if (!crearProceso()) {
+                    REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "No se pudo crear un proceso diferido. Continuando simulación..."
+                         << COLOR_RESET << '\n');
+                }
+            }
+        }
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[CONTROL DE CARGA] Demanda: " << demanda << "/" << capacidad
+             << " marcos | activos: " << procesos_activos.size() << " | suspendidos: " << procesos_suspendidos.size()
+             << " | llegadas diferidas: " << llegadas_diferidas << COLOR_RESET << '\n');
+        programarEvento(TipoEvento::CONTROL_CARGA, tiempo_simulado + config.intervalo_control);
+    }
+    
+    // Suspende un proceso activo: deja de acceder y de poder finalizar hasta reanudarse, y
+    // sus páginas en RAM que no comparte pasan a SWAP (mientras haya ranuras) liberando
+    // sus marcos. Al reanudarse vuelven por fallos de página.
+    void suspenderProceso(int indice_proceso) {
+        Proceso& proceso = procesos[indice_proceso];
+        quitarDeActivos(proceso);
+        procesos_suspendidos.push_back(procesos.referencia(indice_proceso));
+        if (metricas.regiones_enormes > 0) dividirEnormes(proceso);
+        vector<int> residentes;
+        proceso.tabla.recorrer([&](int64_t, int indice_pagina) {
+            if (paginas.enRam(indice_pagina) && !paginas.compartida(indice_pagina)) residentes.push_back(indice_pagina);
+            return true;
+        });
+        int enviadas = 0;
+        for (int indice_pagina : residentes) {
+            if (marcos_swap.libres() == 0) break;
+            expulsarPagina(indice_pagina, -1);
+            enviadas++;
+        }
+        metricas.suspensiones++;
+        metricas.paginas_suspendidas += enviadas;
+        registro.binario(TipoEventoBinario::SUSPENSION, tiempo_simulado, proceso.pid, enviadas, -1);
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_SWAP << "[CONTROL DE CARGA] Proceso PID=" << proceso.pid
+             << " suspendido (conjunto de trabajo de " << proceso.conjunto_trabajo << " páginas, " << enviadas
+             << " páginas a SWAP)" << COLOR_RESET << '\n');
+    }
+    
+    // Reanuda el proceso suspendido hace más tiempo
+    void reanudarProceso() {
+        int indice_proceso = procesos_suspendidos.front().indice;
+        procesos_suspendidos.pop_front();
+        agregarAActivos(indice_proceso);
+        Proceso& proceso = procesos[indice_proceso];
+        metricas.reanudaciones++;
+        registro.binario(TipoEventoBinario::REANUDACION, tiempo_simulado, proceso.pid, proceso.conjunto_trabajo, -1);
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[CONTROL DE CARGA] Proceso PID=" << proceso.pid
+             << " reanudado (conjunto de trabajo de " << proceso.conjunto_trabajo << " páginas)" << COLOR_RESET << '\n');
+    }
+    
+    // Rendimiento estimado en accesos por segundo (tiempo efectivo de acceso): cada acceso
+    // cuesta TIEMPO_ACCESO_US y cada página leída o escrita en SWAP, costo_swap_us
+    double rendimientoEstimado() const {
+        double microsegundos = accesos_memoria * TIEMPO_ACCESO_US +
+                               double(metricas.swap_in + metricas.swap_out) * config.costo_swap_us;
+        return microsegundos > 0 ? accesos_memoria / (microsegundos * 1e-6) : 0.0;
+    }
+    
+    // Despierta al reclamador si quedan menos marcos libres que la marca baja
+    void despertarRecuperacion() {
+        if (marca_alta > 0 && marcos_ram.libres() < marca_baja && !recuperacion_pendiente) {
+            recuperacion_pendiente = true;
+            programarEvento(TipoEvento::RECUPERACION_FONDO, tiempo_simulado);
+        }
+    }
+    
+    // Reclamador en segundo plano (como kswapd): en cada despertar expulsa hasta un lote
+    // de páginas elegidas por la política, hasta tener marca_alta marcos libres. Si no
+    // llegó vuelve a correr tras el intervalo; si llegó, duerme hasta que una asignación
+    // deje menos libres que la marca baja.
+    void atenderRecuperacion() {
+        metricas.despertares_recuperacion++;
+        int expulsadas = 0;
+        while (marcos_ram.libres() < marca_alta && expulsadas < config.lote_recuperacion) {
+            int victima = elegirPaginaVictima();
+            if (victima == -1 || marcos_swap.libres() == 0) break;
+            expulsarPagina(victima, -1);
+            expulsadas++;
+        }
+        metricas.expulsiones_fondo += expulsadas;
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_SWAP << "[RECUPERACIÓN] " << expulsadas
+             << " páginas a SWAP, marcos libres: " << marcos_ram.libres() << "/" << marcos_ram.total() << COLOR_RESET << '\n');
+        if (expulsadas == config.lote_recuperacion && marcos_ram.libres() < marca_alta) {
+            programarEvento(TipoEvento::RECUPERACION_FONDO, tiempo_simulado + config.intervalo_recuperacion);
+        } else {
+            recuperacion_pendiente = false;
+        }
+    }
+    
+    // El escáner de fusión corre si se pidió y hay contenido que comparar
+    bool fusionActiva() const { return config.paginas_ksm > 0 && almacen_swap; }
+    
+    // Suma de verificación de una página para el escáner de fusión (cuatro acumuladores
+    // independientes de 64 bits; el tamaño de página es múltiplo de 32 bytes)
+    uint64_t sumaContenido(const uint8_t* contenido) const {
+        uint64_t suma[4] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0x27D4EB2F165667C5ULL};
+        for (size_t i = 0; i < bytes_pagina; i += 32) {
+            for (int j = 0; j < 4; ++j) suma[j] = (suma[j] ^ leer64(contenido + i + 8 * j)) * 0xFF51AFD7ED558CCDULL;
+        }
+        uint64_t total = suma[0] ^ (suma[1] >> 7) ^ (suma[2] << 11) ^ (suma[3] >> 17);
+        return total ^ (total >> 29);
+    }
+    
+    // Escáner de fusión de páginas iguales (como KSM): en cada despertar calcula la suma
+    // de hasta paginas_ksm páginas en RAM, recorriendo la tabla de páginas en orden. Cada
+    // marco se revisa una vez (por la página que lo ocupa). Solo la página cuya suma no
+    // cambió desde la pasada anterior entra como candidata; si otra candidata tiene la
+    // misma suma y los mismos bytes, se fusionan en un marco compartido con copia en
+    // escritura. Las candidatas se descartan al completar cada pasada.
+    void atenderEscaneoKsm() {
+        size_t capacidad = paginas.capacidad();
+        if (sumas_ksm.size() < capacidad) sumas_ksm.resize(capacidad, {0, 0});
+        int revisadas = 0;
+        unsigned long long fusiones = metricas.fusiones_ksm;
+        for (size_t visitadas = 0; visitadas < capacidad && revisadas < config.paginas_ksm; ++visitadas) {
+            int indice = cursor_ksm;
+            if (++cursor_ksm >= capacidad) {
+                cursor_ksm = 0;
+                candidatas_ksm.clear();
+                metricas.pasadas_ksm++;
+            }
+            if (!paginas.vivo(indice) || !paginas.enRam(indice)) continue;
+            int marco = paginas.ubicacion(indice);
+            if (marcos_ram.ocupante(marco) != indice || paginas.enorme(indice)) continue; // Las enormes no se fusionan
+            revisadas++;
+            
+            uint64_t suma = sumaContenido(contenidoMarco(marco));
+            uint32_t generacion = paginas.generacion(indice) + 1;
+            bool estable = sumas_ksm[indice] == make_pair(generacion, suma);
+            sumas_ksm[indice] = {generacion, suma};
+            if (!estable) continue;
+            
+            auto candidata = candidatas_ksm.find(suma);
+            if (candidata == candidatas_ksm.end()) {
+                candidatas_ksm.emplace(suma, make_pair(indice, generacion));
+                continue;
+            }
+            int otra = candidata->second.first;
+            bool valida = paginas.vivo(otra) && paginas.generacion(otra) + 1 == candidata->second.second &&
+                          paginas.enRam(otra) && !paginas.enorme(otra);
+            if (valida && paginas.ubicacion(otra) == marco) continue; // Ya comparten marco
+            if (!valida || memcmp(contenidoMarco(paginas.ubicacion(otra)), contenidoMarco(marco), bytes_pagina) != 0) {
+                candidata->second = make_pair(indice, generacion);
+                continue;
+            }
+            fusionarPaginas(indice, otra);
+        }
+        metricas.revisadas_ksm += revisadas;
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[KSM] " << revisadas << " páginas revisadas, "
+             << metricas.fusiones_ksm - fusiones << " fusionadas, marcos libres: " << marcos_ram.libres() << "/"
+             << marcos_ram.total() << COLOR_RESET << '\n');
+        programarEvento(TipoEvento::ESCANEO_KSM, tiempo_simulado + config.intervalo_ksm);
+    }
+    
+    // Promotor de páginas enormes (como khugepaged): en cada despertar revisa hasta
+    // regiones_promocion regiones con hoja, siguiendo por los procesos activos desde donde
+    // quedó la vez anterior, y promueve las que ya están completas en RAM
+    void atenderPromocion() {
+        int revisadas = 0, promovidas = 0;
+        size_t procesos_vistos = 0;
+        while (revisadas < config.regiones_promocion && procesos_vistos <= procesos_activos.size()) {
+            if (cursor_promocion >= procesos_activos.size()) {
+                if (procesos_activos.empty()) break;
+                cursor_promocion = 0;
+                region_promocion = 0;
+            }
+            Proceso& proceso = procesos[procesos_activos[cursor_promocion].indice];
+            int64_t region = proceso.tabla.siguienteRegion(region_promocion);
+            if (region == -1) {
+                cursor_promocion++;
+                region_promocion = 0;
+                procesos_vistos++;
+                continue;
+            }
+            revisadas++;
+            if (promoverRegion(proceso, region)) promovidas++;
+            region_promocion = region + 1;
+        }
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[PROMOCIÓN] " << revisadas << " regiones revisadas, "
+             << promovidas << " promovidas a páginas enormes, marcos libres: " << marcos_ram.libres() << "/"
+             << marcos_ram.total() << COLOR_RESET << '\n');
+        programarEvento(TipoEvento::PROMOCION_ENORMES, tiempo_simulado + config.intervalo_promocion);
+    }
+    
+    // Promueve una región a página enorme si sus PAGINAS_ENORME páginas existen, están en
+    // RAM y no se comparten: se copian a un bloque alineado libre, se liberan sus marcos
+    // sueltos y la región pasa a traducirse con una sola entrada. Retorna si la promovió.
+    bool promoverRegion(Proceso& proceso, int64_t region) {
+        if (!regionApta(proceso, region) || proceso.tabla.enorme(region)) return false;
+        const int* ranuras = proceso.tabla.region(region);
+        for (int i = 0; i < PAGINAS_ENORME; ++i) {
+            if (ranuras[i] == -1 || !paginas.enRam(ranuras[i]) || paginas.compartida(ranuras[i])) return false;
+        }
+        if (!marcos_ram.hayBloqueLibre() || marcos_ram.libres() < marca_min + PAGINAS_ENORME) {
+            metricas.promociones_sin_bloque++;
+            return false;
+        }
+        int64_t primera = region << BITS_ENORME;
+        int primer_marco = marcos_ram.asignarBloque(ranuras);
+        for (int i = 0; i < PAGINAS_ENORME; ++i) {
+            int anterior = paginas.ubicacion(ranuras[i]);
+            uint64_t clave = clavePagina(proceso.pid, primera + i);
+            if (almacen_swap) memcpy(contenidoMarco(primer_marco + i), contenidoMarco(anterior), bytes_pagina);
+            politica.alLiberar(anterior, clave);
+            marcos_ram.liberar(anterior);
+            paginas.reubicar(ranuras[i], primer_marco + i);
+            paginas.marcarEnorme(ranuras[i], true);
+            politica.alCargar(primer_marco + i, clave);
+            if (tlb.activa()) tlb.invalidar(proceso.pid, primera + i);
+        }
+        proceso.tabla.marcarEnorme(region, true);
+        metricas.regiones_enormes++;
+        metricas.enormes_promovidas++;
+        registro.binario(TipoEventoBinario::ENORME, tiempo_simulado, proceso.pid, primera, primer_marco);
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Región " << region << " (PID=" << proceso.pid
+             << ") promovida a página enorme (marcos " << primer_marco << "-" << primer_marco + PAGINAS_ENORME - 1 << ")"
+             << COLOR_RESET << '\n');
+        despertarRecuperacion();
+        return true;
+    }
+    
+    // Fusiona una página (y las que ya comparten su marco) con otra de igual contenido:
+    // todas pasan al marco de la otra y el suyo queda libre
+    void fusionarPaginas(int indice_pagina, int otra) {
+        int marco = paginas.ubicacion(indice_pagina);
+        int marco_otra = paginas.ubicacion(otra);
+        int miembro = indice_pagina;
+        do {
+            if (tlb.activa()) tlb.invalidar(procesos[paginas.dueno(miembro)].pid, paginas.idPagina(miembro));
+            paginas.reubicar(miembro, marco_otra);
+            miembro = paginas.siguienteCompartida(miembro);
+        } while (miembro != indice_pagina);
+        int pid = procesos[paginas.dueno(indice_pagina)].pid;
+        politica.alLiberar(marco, clavePagina(pid, paginas.idPagina(indice_pagina)));
+        marcos_ram.liberar(marco);
+        paginas.unirAnillos(indice_pagina, otra);
+        metricas.fusiones_ksm++;
+        sumarCompartida();
+        registro.binario(TipoEventoBinario::FUSION, tiempo_simulado, pid, paginas.idPagina(indice_pagina), marco_otra);
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Fusión: página " << paginas.idGlobal(indice_pagina)
+             << " (PID=" << pid << "-" << paginas.idPagina(indice_pagina) << ") igual a la página " << paginas.idGlobal(otra)
+             << ", comparte su marco " << marco_otra << " y libera el " << marco << COLOR_RESET << '\n');
+    }
+    
+    // Mueve la página víctima a SWAP y entrega su marco a la página nueva (o lo deja
+    // libre si indice_pagina es -1). Retorna el marco o -1 si no hay espacio en SWAP.
+    int expulsarPagina(int indice_victima, int indice_pagina) {
+        int marco_victima = paginas.ubicacion(indice_victima);
+        int pid_victima = procesos[paginas.dueno(indice_victima)].pid;
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_SWAP << "  → Víctima seleccionada: Página " << paginas.idGlobal(indice_victima) 
+             << " (PID=" << pid_victima << "-" << paginas.idPagina(indice_victima) 
+             << ") (marco " << marco_victima << ")" << COLOR_RESET << '\n');
+        
+        // Mover víctima a SWAP
+        int marco_swap_libre = marcos_swap.asignar(indice_victima);
+        if (marco_swap_libre == -1) {
+            REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "  → ERROR: No hay espacio en SWAP" << COLOR_RESET << '\n');
+            return -1;
+        }
+        
+        // Una página enorme se divide y solo sale la página base elegida
+        if (paginas.enorme(indice_victima)) {
+            dividirRegion(procesos[paginas.dueno(indice_victima)], paginas.idPagina(indice_victima) >> BITS_ENORME);
+        }
+        
+        // Realizar swap-out de la víctima: su marco pasa directamente a la página solicitada
+        if (indice_pagina == -1) marcos_ram.liberar(marco_victima);
+        else marcos_ram.reasignar(marco_victima, indice_pagina);
+        politica.alExpulsar(marco_victima, clavePagina(pid_victima, paginas.idPagina(indice_victima)));
+        
+        // Las páginas que comparten el marco pasan juntas a la misma ranura
+        int miembro = indice_victima;
+        do {
+            Proceso& dueno = procesos[paginas.dueno(miembro)];
+            if (tlb.activa()) tlb.invalidar(dueno.pid, paginas.idPagina(miembro));
+            if (paginas.anticipada(miembro)) metricas.anticipadas_sin_uso++;
+            paginas.moverASwap(miembro, marco_swap_libre);
+            dueno.paginas_residentes--;
+            miembro = paginas.siguienteCompartida(miembro);
+        } while (miembro != indice_victima);
+        if (almacen_swap) guardarEnSwap(marco_swap_libre, contenidoMarco(marco_victima));
+        metricas.expulsiones++;
+        metricas.swap_out++;
+        registro.binario(TipoEventoBinario::EXPULSION, tiempo_simulado, pid_victima,
+                         paginas.idPagina(indice_victima), marco_swap_libre);
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_SWAP << "  → Víctima movida a SWAP (marco " << marco_swap_libre << ")" << COLOR_RESET << '\n');
+        
+        return marco_victima;
+    }
+
+    // Accede a una página de un proceso: acierto o fallo de página con reemplazo
+    bool accederPagina(Proceso& proceso, int64_t pagina_acceder, bool escritura) {
+        // Obtener la página específica
+        int indice_pagina = proceso.tabla.buscar(pagina_acceder);
+        uint64_t clave = clavePagina(proceso.pid, pagina_acceder);
+        politica.alReferenciar(clave);
+        accesos_memoria++;
+        bool primer_toque = false;
+        if (indice_pagina == -1) {
+            // Página nunca tocada (paginación por demanda): se crea. Cuenta como fallo de
+            // página; si quedó compartiendo una página en SWAP la cuenta el fallo que la trae
+            indice_pagina = atenderPrimerToque(proceso, pagina_acceder);
+            if (indice_pagina == -1) return false;
+            primer_toque = paginas.enRam(indice_pagina);
+            if (primer_toque) fallos_pagina++;
+        }
+        if (config.ventana_trabajo > 0) registrarReferencia(proceso, indice_pagina);
+        if (primer_toque) return terminarPrimerToque(proceso, pagina_acceder, indice_pagina, escritura);
+        int64_t id_global = paginas.idGlobal(indice_pagina);
+        
+        // Consultar la TLB antes de recorrer la tabla de páginas
+        int marco_tlb = -1;
+        if (tlb.activa()) {
+            tlb.cambiarContexto(proceso.pid);
+            marco_tlb = tlb.buscar(proceso.pid, pagina_acceder);
+        }
+        
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[ACCESO] PID=" << proceso.pid 
+             << " → Página: " << id_global << " (local:" << pagina_acceder << ")"
+             << " → En RAM: " << (paginas.enRam(indice_pagina) ? "Sí" : "No") << COLOR_RESET << '\n');
+        
+        // Si la página ya está en RAM, acceso normal
+        if (marco_tlb != -1 || paginas.enRam(indice_pagina)) {
+            int marco = marco_tlb;
+            if (marco == -1) {
+                marco = paginas.ubicacion(indice_pagina);
+                if (tlb.activa()) insertarTraduccion(proceso.pid, pagina_acceder, indice_pagina, marco);
+            }
+            REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Página " << id_global 
+                 << " YA en RAM (marco " << marco << ")" << COLOR_RESET << '\n');
+            paginas.marcarReferenciada(indice_pagina);
+            if (paginas.anticipada(indice_pagina)) {
+                // Primer uso de una página anticipada: la anticipación acertó
+                paginas.desmarcarAnticipada(indice_pagina);
+                proceso.aciertos_anticipacion++;
+                metricas.aciertos_anticipados++;
+            }
+            if (escritura) {
+                if (paginas.compartida(indice_pagina)) {
+                    marco = copiarAlEscribir(proceso, pagina_acceder, indice_pagina);
+                    if (marco == -1) return false;
+                }
+                soltarBiblioteca(indice_pagina, -1);
+                paginas.marcarSucia(indice_pagina);
+                if (almacen_swap) escribirContenido(contenidoMarco(marco));
+            }
+            politica.alAcceder(marco, clave);
+            registro.binario(TipoEventoBinario::ACIERTO, tiempo_simulado, proceso.pid, pagina_acceder, marco);
+            return true;
+        }
+        
+        // Esto es para los fallos de página
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_FALLO << "  → FALLO DE PÁGINA! Página " << id_global 
+             << " no está en RAM" << COLOR_RESET << '\n');
+        fallos_pagina++; // Incrementar contador de fallos de página
+        uint64_t inicio_fallo = metricas_activas ? marcaTiempo() : 0;
+        
+        // Buscar marco libre en RAM
+        int marco_libre = obtenerMarcoLibre(indice_pagina);
+        
+        if (marco_libre == -1) {
+            // RAM llena, necesitamos reemplazar una página según la política (recuperación directa)
+            REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_FALLO << "  → RAM llena, buscando víctima para reemplazar..." << COLOR_RESET << '\n');
+            int indice_victima = elegirPaginaVictima();
+            
+            if (indice_victima == -1) {
+                REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "  → ERROR: No se encontró víctima para reemplazar" << COLOR_RESET << '\n');
+                return false;
+            }
+            
+            marco_libre = expulsarPagina(indice_victima, indice_pagina); // Usar el marco liberado
+            if (marco_libre == -1) return false;
+            metricas.recuperacion_directa++;
+        }
+        
+        // Mover la página solicitada a RAM (swap-in); en modo contenido la lectura corre
+        // en el pool de E/S mientras se actualizan las estructuras
+        int marco_swap = paginas.ubicacion(indice_pagina);
+        unique_ptr<SolicitudES> lectura;
+        if (almacen_swap) lectura = leerDeSwap(marco_swap, contenidoMarco(marco_libre));
+        marcos_swap.liberar(marco_swap);  // Liberar espacio en SWAP
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_SWAP << "  → Página " << id_global 
+             << " liberada de SWAP (marco " << marco_swap << ")" << COLOR_RESET << '\n');
+        
+        // Actualizar estado de la página (y de las que comparten su ranura)
+        cargarPaginas(indice_pagina, marco_libre);
+        metricas.swap_in++;
+        politica.alCargar(marco_libre, clave);
+        if (tlb.activa()) tlb.insertar(proceso.pid, pagina_acceder, marco_libre);
+        if (almacen_swap) {
+            almacen_swap->esperar(lectura);
+            liberarRanura(marco_swap);
+            if (!verificarContenido(contenidoMarco(marco_libre), paginas.idContenido(indice_pagina))) errores_contenido++;
+        }
+        if (escritura) {
+            if (paginas.compartida(indice_pagina)) {
+                marco_libre = copiarAlEscribir(proceso, pagina_acceder, indice_pagina);
+                if (marco_libre == -1) return false;
+            }
+            soltarBiblioteca(indice_pagina, -1);
+            paginas.marcarSucia(indice_pagina);
+            if (almacen_swap) escribirContenido(contenidoMarco(marco_libre));
+        }
+        registro.binario(TipoEventoBinario::FALLO, tiempo_simulado, proceso.pid, pagina_acceder, marco_libre);
+        
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Página " << id_global 
+             << " movida a RAM (marco " << marco_libre << ")" << COLOR_RESET << '\n');
+        if (config.paginas_anticipacion > 0) leerAnticipado(proceso, pagina_acceder, indice_pagina, marco_swap);
+        if (metricas_activas) metricas.costo_fallo.registrar(marcaTiempo() - inicio_fallo);
+        return true;
+    }
+    
+    // Primer acceso a una página que aún no existe (paginación por demanda): fallo "en
+    // cero", sin lectura de SWAP. Si su región es apta y está vacía se mapea entera como
+    // página enorme; si no, se crea solo esta página en un marco libre (o expulsando una
+    // víctima), o comparte la de la biblioteca común si otro proceso ya la tiene.
+    // Retorna la ranura de la página o -1 si no hay dónde ponerla.
+    int atenderPrimerToque(Proceso& proceso, int64_t pagina) {
+        int indice_proceso = procesos_activos[proceso.posicion_activa].indice;
+        int64_t region = pagina >> BITS_ENORME;
+        const int* ranuras = proceso.tabla.region(region);
+        if (regionApta(proceso, region) &&
+            (ranuras == nullptr || all_of(ranuras, ranuras + PAGINAS_ENORME, [](int ranura) { return ranura == -1; })) &&
+            mapearRegionEnorme(indice_proceso, region)) {
+            int indice_pagina = proceso.tabla.buscar(pagina);
+            metricas.fallos_demanda++;
+            registro.binario(TipoEventoBinario::PRIMER_TOQUE, tiempo_simulado, proceso.pid, pagina, paginas.ubicacion(indice_pagina));
+            return indice_pagina;
+        }
+        
+        int indice_pagina = crearPagina(indice_proceso, pagina, false);
+        if (size_t(pagina) < paginas_biblioteca.size()) {
+            if (paginas_biblioteca[pagina] != -1) {
+                numerarPagina(indice_pagina);
+                metricas.fallos_demanda++;
+                compartirPagina(proceso, indice_pagina, paginas_biblioteca[pagina]);
+                registro.binario(TipoEventoBinario::PRIMER_TOQUE, tiempo_simulado, proceso.pid, pagina,
+                                 paginas.enRam(indice_pagina) ? paginas.ubicacion(indice_pagina) : -1);
+                return indice_pagina;
+            }
+            paginas_biblioteca[pagina] = indice_pagina;
+        }
+        int marco = obtenerMarcoLibre(indice_pagina);
+        if (marco == -1) {
+            int victima = elegirPaginaVictima();
+            if (victima != -1) marco = expulsarPagina(victima, indice_pagina);
+            if (marco == -1) {
+                REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "  → ERROR: No hay marco para la página nueva"
+                     << COLOR_RESET << '\n');
+                soltarBiblioteca(indice_pagina, -1);
+                proceso.tabla.mapear(pagina, -1);
+                proceso.paginas_mapeadas--;
+                paginas.liberar(indice_pagina);
+                return -1;
+            }
+            metricas.recuperacion_directa++;
+        }
+        numerarPagina(indice_pagina);
+        metricas.fallos_demanda++;
+        paginas.moverARam(indice_pagina, marco);
+        proceso.paginas_residentes++;
+        if (almacen_swap) inicializarContenido(contenidoMarco(marco), paginas.idContenido(indice_pagina));
+        politica.alCargar(marco, clavePagina(proceso.pid, pagina));
+        registro.binario(TipoEventoBinario::PRIMER_TOQUE, tiempo_simulado, proceso.pid, pagina, marco);
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Primer toque: página " << paginas.idGlobal(indice_pagina)
+             << " (PID=" << proceso.pid << "-" << pagina << ") creada en RAM (marco " << marco << ")" << COLOR_RESET << '\n');
+        return indice_pagina;
+    }
+    
+    // Termina un acceso cuyo primer toque dejó la página en RAM. No pasa por la rama de
+    // aciertos: la política ya la vio cargarse y el evento PRIMER_TOQUE ya se emitió. Solo
+    // una página de la biblioteca reutiliza un marco residente, y ese marco sí se referencia.
+    bool terminarPrimerToque(Proceso& proceso, int64_t pagina, int indice_pagina, bool escritura) {
+        int marco = paginas.ubicacion(indice_pagina);
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[ACCESO] PID=" << proceso.pid
+             << " → Página: " << paginas.idGlobal(indice_pagina) << " (local:" << pagina << ")"
+             << " → Primer toque" << COLOR_RESET << '\n');
+        if (tlb.activa()) {
+            // La traducción no estaba: la TLB cuenta el fallo como en cualquier fallo de página
+            tlb.cambiarContexto(proceso.pid);
+            tlb.buscar(proceso.pid, pagina);
+            insertarTraduccion(proceso.pid, pagina, indice_pagina, marco);
+        }
+        paginas.marcarReferenciada(indice_pagina);
+        if (paginas.compartida(indice_pagina)) politica.alAcceder(marco, clavePagina(proceso.pid, pagina));
+        if (escritura) {
+            if (paginas.compartida(indice_pagina)) {
+                marco = copiarAlEscribir(proceso, pagina, indice_pagina);
+                if (marco == -1) return false;
+            }
+            soltarBiblioteca(indice_pagina, -1);
+            paginas.marcarSucia(indice_pagina);
+            if (almacen_swap) escribirContenido(contenidoMarco(marco));
+        }
+        return true;
+    }
+    
+    // Carga en la TLB la traducción de la página, o la de su página enorme si es parte de una
+    void insertarTraduccion(int pid, int64_t pagina, int indice_pagina, int marco) {
+        if (paginas.enorme(indice_pagina)) {
+            tlb.insertarEnorme(pid, pagina >> BITS_ENORME, marco - static_cast<int>(pagina & (PAGINAS_ENORME - 1)));
+        } else {
+            tlb.insertar(pid, pagina, marco);
+        }
+    }
+    
+    // La página (y las que comparten su ranura de SWAP) pasa al marco de RAM indicado
+    void cargarPaginas(int indice_pagina, int marco) {
+        int miembro = indice_pagina;
+        do {
+            paginas.moverARam(miembro, marco);
+            procesos[paginas.dueno(miembro)].paginas_residentes++;
+            miembro = paginas.siguienteCompartida(miembro);
+        } while (miembro != indice_pagina);
+    }
+    
+    // Primera escritura sobre una página compartida (copia en escritura): la página recibe
+    // un marco propio con una copia del contenido y sale del anillo; las demás siguen en
+    // el marco original. Retorna el marco nuevo o -1 si no hay memoria para la copia.
+    int copiarAlEscribir(Proceso& proceso, int64_t pagina, int indice_pagina) {
+        int marco_original = paginas.ubicacion(indice_pagina);
+        int marco = obtenerMarcoLibre(indice_pagina);
+        if (marco == -1) {
+            // La víctima no puede ser el marco que se está copiando: la política lo salta
+            int victima = elegirPaginaVictima(marco_original);
+            if (victima != -1) marco = expulsarPagina(victima, indice_pagina);
+            if (marco == -1) {
+                REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "  → ERROR: No hay marco para la copia en escritura"
+                     << COLOR_RESET << '\n');
+                return -1;
+            }
+            metricas.recuperacion_directa++;
+        }
+        if (almacen_swap) memcpy(contenidoMarco(marco), contenidoMarco(marco_original), bytes_pagina);
+        separarCompartida(indice_pagina);
+        paginas.reubicar(indice_pagina, marco);
+        politica.alCargar(marco, clavePagina(proceso.pid, pagina));
+        if (tlb.activa()) {
+            tlb.invalidar(proceso.pid, pagina);
+            tlb.insertar(proceso.pid, pagina, marco);
+        }
+        metricas.copias_escritura++;
+        registro.binario(TipoEventoBinario::COPIA_ESCRITURA, tiempo_simulado, proceso.pid, pagina, marco);
+        REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Copia en escritura: página " << paginas.idGlobal(indice_pagina)
+             << " (PID=" << proceso.pid << "-" << pagina << ") del marco compartido " << marco_original
+             << " a su propio marco " << marco << COLOR_RESET << '\n');
+        return marco;
+    }
+    
+    // Páginas a anticipar en este fallo, adaptadas como el swap readahead de Linux: la
+    // ventana (contando la página del fallo) es la cantidad de anticipadas usadas desde
+    // la lectura anterior + 2, redondeada a potencia de 2 y acotada por el máximo. Sin
+    // aciertos solo se anticipa si el fallo sigue al anterior (recorrido), y la ventana
+    // nunca cae a menos de la mitad de la anterior de una vez.
+    int ventanaAnticipacion(Proceso& proceso, int64_t pagina) {
+        int ventana = proceso.aciertos_anticipacion + 2;
+        if (proceso.aciertos_anticipacion == 0) {
+            if (llabs(pagina - proceso.ultimo_fallo) != 1) ventana = 1;
+        } else {
+            int redondeo = 4;
+            while (redondeo < ventana) redondeo <<= 1;
+            ventana = redondeo;
+        }
+        ventana = min(ventana, config.paginas_anticipacion + 1);
+        ventana = max(ventana, proceso.ventana_anticipacion / 2);
+        proceso.ventana_anticipacion = ventana;
+        proceso.aciertos_anticipacion = 0;
+        proceso.ultimo_fallo = pagina;
+        return ventana - 1;
+    }
+    
+    // Lectura anticipada tras el fallo de una página: trae en un solo lote páginas del
+    // mismo proceso que están en SWAP. En modo "virtual" son las páginas siguientes a la
+    // del fallo; en modo "swap", las que ocupan las ranuras siguientes a la suya (se
+    // expulsaron junto a ella). Primero se eligen las candidatas y se les consigue marco
+    // (expulsando si hace falta, nunca a la página del fallo ni a otra del lote); luego
+    // salen todas las lecturas juntas. Sus ranuras se liberan al terminar de leer, así
+    // las expulsiones del lote no pueden reutilizarlas mientras se leen.
+    void leerAnticipado(Proceso& proceso, int64_t pagina_fallo, int indice_fallo, int ranura_fallo) {
+        int ventana = ventanaAnticipacion(proceso, pagina_fallo);
+        lote_anticipado.clear();
+        for (int d = 1; d <= ventana; ++d) {
+            int indice;
+            if (config.modo_anticipacion == "swap") {
+                size_t ranura = size_t(ranura_fallo) + d;
+                if (ranura >= marcos_swap.total()) break;
+                indice = marcos_swap.ocupante(ranura);
+                if (indice == -1 || paginas.dueno(indice) != paginas.dueno(indice_fallo)) continue;
+            } else {
+                if (pagina_fallo + d >= proceso.num_paginas) break;
+                indice = proceso.tabla.buscar(pagina_fallo + d);
+                if (indice == -1 || paginas.enRam(indice)) continue;
+                // Dos páginas del proceso pueden compartir ranura (fusionadas): se lee una vez
+                int ranura = paginas.ubicacion(indice);
+                if (paginas.compartida(indice) && any_of(lote_anticipado.begin(), lote_anticipado.end(),
+                        [ranura](const pair<int, int>& otra) { return otra.second == ranura; })) continue;
+            }
+            lote_anticipado.push_back({indice, paginas.ubicacion(indice)});
+        }
+        
+        size_t cargadas = 0;
+        for (; cargadas < lote_anticipado.size(); ++cargadas) {
+            int indice = lote_anticipado[cargadas].first;
+            int marco = obtenerMarcoLibre(indice);
+            if (marco == -1) {
+                int victima = elegirPaginaVictima();
+                bool del_lote = (victima == indice_fallo);
+                for (size_t j = 0; j < cargadas && !del_lote; ++j) del_lote = (lote_anticipado[j].first == victima);
+                if (victima == -1 || del_lote || marcos_swap.libres() == 0) break;
+                marco = expulsarPagina(victima, indice);
+                metricas.expulsiones_anticipacion++;
+            }
+            int64_t id_pagina = paginas.idPagina(indice);
+            cargarPaginas(indice, marco);
+            paginas.marcarAnticipada(indice);
+            politica.alCargar(marco, clavePagina(proceso.pid, id_pagina));
+            metricas.swap_in++;
+            metricas.anticipadas++;
+            registro.binario(TipoEventoBinario::ANTICIPACION, tiempo_simulado, proceso.pid, id_pagina, marco);
+            REGISTRAR(registro, NivelRegistro::DETALLE, COLOR_RAM << "  → Lectura anticipada: página " << paginas.idGlobal(indice)
+                 << " (PID=" << proceso.pid << "-" << id_pagina << ") de SWAP (marco " << lote_anticipado[cargadas].second
+                 << ") a RAM (marco " << marco << ")" << COLOR_RESET << '\n');
+        }
+        lote_anticipado.resize(cargadas);
+        
+        if (almacen_swap) {
+            pedidos_anticipados.clear();
+            for (const pair<int, int>& anticipada : lote_anticipado) {
+                uint8_t* destino = contenidoMarco(paginas.ubicacion(anticipada.first));
+                if (cache_comprimida && cache_comprimida->cargar(anticipada.second, destino)) continue;
+                pedidos_anticipados.push_back({anticipada.second, destino});
+            }
+            almacen_swap->leerVarias(pedidos_anticipados, lecturas_anticipadas);
+            for (unique_ptr<SolicitudES>& lectura : lecturas_anticipadas) almacen_swap->esperar(lectura);
+            lecturas_anticipadas.clear();
+        }
+        for (const pair<int, int>& anticipada : lote_anticipado) {
+            marcos_swap.liberar(anticipada.second);
+            if (!almacen_swap) continue;
+            liberarRanura(anticipada.second);
+            int indice = anticipada.first;
+            if (!verificarContenido(contenidoMarco(paginas.ubicacion(indice)), paginas.idContenido(indice))) errores_contenido++;
+        }
+    }
+
+    // Muestra el estado actual del sistema
+    void mostrarEstado() {
+        if (!registro.habilitado(NivelRegistro::EVENTOS)) return;
+        // Calcular uso de RAM
+        size_t ram_usada = marcos_ram.usados();
+        // Calcular uso de SWAP
+        size_t swap_usada = marcos_swap.usados();
+        // Procesos activos y páginas en SWAP (cada una ocupa un marco de SWAP)
+        size_t num_activos = procesos_activos.size();
+        size_t paginas_en_swap = marcos_swap.usados();
+        
+        // Mostrar estado completo
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[ESTADO] RAM: " << ram_usada << "/" << marcos_ram.total()
+             << " | SWAP: " << swap_usada << "/" << marcos_swap.total()
+             << " | Procesos: " << num_activos
+             << " | Páginas en SWAP: " << paginas_en_swap
+             << " | Fallos de Página: " << fallos_pagina 
+             << " | Total páginas: " << (siguiente_id_pagina - 1));
+        if (config.ventana_trabajo > 0 && config.control_carga) {
+            REGISTRAR(registro, NivelRegistro::EVENTOS, " | Suspendidos: " << procesos_suspendidos.size()
+                 << " | Llegadas diferidas: " << llegadas_diferidas);
+        }
+        REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_RESET << '\n');
+    }
+
+    // Programa un evento en el instante simulado indicado
+    void programarEvento(TipoEvento tipo, double tiempo) {
+        cola_eventos.push(Evento{tiempo, secuencia_eventos++, tipo});
+    }
+
+    // Intervalo hasta la próxima ocurrencia de un evento con la tasa dada
+    double siguienteIntervalo(double tasa) {
+        if (config.intervalos_poisson) {
+            exponential_distribution<double> distribucion_intervalo(tasa);
+            return distribucion_intervalo(generador_aleatorio);
+        }
+        return 1.0 / tasa;
+    }
+
+    // Programa la siguiente ocurrencia de un evento recurrente (tasa <= 0 lo desactiva)
+    void reprogramarEvento(TipoEvento tipo, double tasa, double desde) {
+        if (tasa > 0.0) {
+            programarEvento(tipo, desde + siguienteIntervalo(tasa));
+        }
+    }
+
+    // Atiende la llegada de un proceso
+    void atenderLlegada() {
+        if (config.max_procesos == 0 || procesos_creados + llegadas_diferidas < static_cast<unsigned long long>(config.max_procesos)) {
+            if (diferirLlegada()) {
+                llegadas_diferidas++;
+                metricas.llegadas_diferidas++;
+                REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "[CONTROL DE CARGA] Llegada diferida: otro conjunto de trabajo "
+                     << "no cabe en RAM (" << llegadas_diferidas << " esperando)" << COLOR_RESET << '\n');
+            } else if (!crearProceso()) {
+                REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "No se puede crear más procesos. Continuando simulación..." << COLOR_RESET << '\n');
+            }
+            mostrarEstado();
+        }
+        reprogramarEvento(TipoEvento::LLEGADA_PROCESO, config.tasa_llegadas, tiempo_simulado);
+    }
+
+    // Atiende la finalización de un proceso aleatorio
+    void atenderFinalizacion() {
+        // Finalizar proceso aleatorio (solo si hay procesos)
+        if (procesos_creados > 0) {
+            finalizarProcesoAleatorio();
+            mostrarEstado();
+        }
+        reprogramarEvento(TipoEvento::FINALIZACION_PROCESO, config.tasa_finalizaciones, tiempo_simulado);
+    }
+
+    // Atiende un acceso a memoria de un proceso activo
+    void atenderAcceso() {
+        if (!procesos_activos.empty()) {
+            REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_INFO << "--- ACCESO A MEMORIA ALEATORIO ---" << COLOR_RESET << '\n');
+            if (!simularAccesoMemoria()) {
+                REGISTRAR(registro, NivelRegistro::EVENTOS, COLOR_ERROR << "Error en acceso a memoria. Continuando..." << COLOR_RESET << '\n');
+            }
+            mostrarEstado();
+        }
+        reprogramarEvento(TipoEvento::ACCESO_MEMORIA, config.tasa_accesos, tiempo_simulado);
+    }
+
+    // Función principal que ejecuta la simulación
+    void ejecutarSimulacion() {
+        auto inicio_real = chrono::steady_clock::now();
         
-        // Calcular número de marcos
-        int num_marcos_ram = memoria_fisica_mb / tamano_pagina_mb;      // Marcos en RAM
-        int total_marcos = memoria_virtual_mb / tamano_pagina_mb;       // Marcos totales (RAM + SWAP)
-        int num_marcos_swap = total_marcos - num_marcos_ram;            // Marcos en SWAP
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "=== INICIANDO SIMULACIÓN ===" << COLOR_RESET << '\n');
+        if (restaurado) {
+            // Los eventos pendientes vienen en el estado restaurado
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Continuando desde t = " << tiempo_simulado
+                 << " s hasta " << config.duracion << " s simulados" << COLOR_RESET << '\n');
+        } else {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Nota: Los eventos periódicos (accesos y finalizaciones) comenzarán después de "
+                 << config.inicio_periodicos << " segundos simulados" << COLOR_RESET << '\n');
+            
+            // Eventos iniciales: la primera llegada ocurre tras un intervalo y los periódicos
+            // empiezan justo en inicio_periodicos, igual que antes
+            reprogramarEvento(TipoEvento::LLEGADA_PROCESO, config.tasa_llegadas, 0.0);
+            if (config.tasa_finalizaciones > 0.0) programarEvento(TipoEvento::FINALIZACION_PROCESO, config.inicio_periodicos);
+            if (config.tasa_accesos > 0.0) programarEvento(TipoEvento::ACCESO_MEMORIA, config.inicio_periodicos);
+            if (metricas_activas) programarEvento(TipoEvento::INSTANTANEA_METRICAS, config.intervalo_metricas);
+            if (fusionActiva()) programarEvento(TipoEvento::ESCANEO_KSM, config.intervalo_ksm);
+            if (config.paginas_enormes) programarEvento(TipoEvento::PROMOCION_ENORMES, config.intervalo_promocion);
+            if (config.ventana_trabajo > 0) programarEvento(TipoEvento::CONTROL_CARGA, config.intervalo_control);
+        }
         
-        // Asegurar valores mínimos
-        if (num_marcos_ram <= 0) num_marcos_ram = 1;
-        if (num_marcos_swap <= 0) num_marcos_swap = total_marcos; // Asegurar suficiente swap
+        // Bucle principal: atender eventos en orden de tiempo simulado
+        while (true) {
+            // Verificar si hay memoria disponible antes de sacar el siguiente evento, así un
+            // estado guardado con la memoria agotada también termina sin atender más eventos
+            if (marcos_ram.libres() == 0 && marcos_swap.libres() == 0) {
+                REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_ERROR << "Memoria agotada. Finalizando simulación." << COLOR_RESET << '\n');
+                break;
+            }
+            if (cola_eventos.empty()) {
+                REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "No quedan eventos pendientes. Finalizando." << COLOR_RESET << '\n');
+                break;
+            }
+            
+            Evento evento = cola_eventos.top();
+            
+            // Terminar al alcanzar la duración configurada
+            if (evento.tiempo > config.duracion) {
+                tiempo_simulado = config.duracion;
+                REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Tiempo de simulación completado. Finalizando." << COLOR_RESET << '\n');
+                break;
+            }
+            
+            cola_eventos.pop();
+            tiempo_simulado = evento.tiempo; // Avanzar el reloj virtual directamente al evento
+            eventos_procesados++;
+            
+            switch (evento.tipo) {
+                case TipoEvento::LLEGADA_PROCESO:      atenderLlegada();      break;
+                case TipoEvento::FINALIZACION_PROCESO: atenderFinalizacion(); break;
+                case TipoEvento::ACCESO_MEMORIA:       atenderAcceso();       break;
+                case TipoEvento::INSTANTANEA_METRICAS:
+                    escribirInstantanea();
+                    programarEvento(TipoEvento::INSTANTANEA_METRICAS, tiempo_simulado + config.intervalo_metricas);
+                    break;
+                case TipoEvento::RECUPERACION_FONDO:   atenderRecuperacion(); break;
+                case TipoEvento::ESCANEO_KSM:          atenderEscaneoKsm();   break;
+                case TipoEvento::PROMOCION_ENORMES:    atenderPromocion();    break;
+                case TipoEvento::CONTROL_CARGA:        atenderControlCarga(); break;
+            }
+        }
         
-        // Inicializar vectores de memoria (todos libres inicialmente: -1)
-        marcos_ram.resize(num_marcos_ram, -1);
-        marcos_swap.resize(num_marcos_swap, -1);
+        // Mostrar estadísticas finales
+        if (almacen_swap) almacen_swap->vaciar();
+        duracion_real = chrono::duration<double>(chrono::steady_clock::now() - inicio_real).count();
+        if (metricas_activas) escribirInstantanea();
+        if (!config.archivo_guardar_estado.empty()) {
+            string error;
+            if (!guardarEstado(config.archivo_guardar_estado, error)) {
+                REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_ERROR << "No se pudo guardar el estado: " << error << COLOR_RESET << '\n');
+            }
+        }
+        mostrarEstadisticasFinales();
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Eventos procesados: " << eventos_procesados << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Tiempo real: " << duracion_real << " s ("
+             << (duracion_real > 0 ? eventos_procesados / duracion_real : 0.0) << " eventos/s)" << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "============================" << COLOR_RESET << '\n');
+        registro.vaciar();
+    }
+
+    // Claves de página que accederá la traza, en orden. Los PIDs se asignan en orden de
+    // primera aparición, igual que en reproducirTraza (para políticas fuera de línea).
+    vector<uint64_t> clavesFuturas(const LectorTraza& traza) const {
+        vector<int> pid_simulado(traza.numProcesos(), -1);
+        int proximo_pid = siguiente_pid;
+        vector<uint64_t> claves;
+        claves.reserve(traza.numRegistros());
+        const RegistroTraza* registros = traza.registros();
+        for (uint64_t r = 0; r < traza.numRegistros(); ++r) {
+            int& pid = pid_simulado[registros[r].proceso];
+            if (pid == -1) pid = proximo_pid++;
+            uint64_t direccion = registros[r].direccion & ~TRAZA_BIT_ESCRITURA;
+            if (direccion < BYTES_ESPACIO_VIRTUAL) claves.push_back(clavePagina(pid, direccion / bytes_pagina));
+        }
+        return claves;
+    }
+
+    // Reproduce una traza binaria por el mismo camino de fallos y reemplazo. Cada proceso
+    // de la traza se crea en su primer acceso (con páginas hasta su mayor dirección) y se
+    // finaliza después del último. Las direcciones fuera del espacio virtual de 48 bits
+    // se omiten.
+    void reproducirTraza(const LectorTraza& traza) {
+        auto inicio_real = chrono::steady_clock::now();
+        const RegistroTraza* registros = traza.registros();
+        const ProcesoTraza* tabla = traza.procesosTraza();
         
-        // Mostrar configuración inicial
-        cout << COLOR_INFO << "=== CONFIGURACIÓN INICIAL ===" << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Memoria Física: " << memoria_fisica_mb << " MB" << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Memoria Virtual: " << memoria_virtual_mb << " MB" << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Tamaño Página: " << tamano_pagina_mb << " MB" << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Marcos RAM: " << num_marcos_ram << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Marcos SWAP: " << num_marcos_swap << COLOR_RESET << endl;
-        cout << COLOR_INFO << "=============================" << COLOR_RESET << endl;
+        // Proceso del simulador de cada proceso de la traza (índice -1 = aún no creado,
+        // -2 = no se pudo crear y sus accesos se omiten)
+        vector<ReferenciaSlab> procesos_traza(traza.numProcesos(), ReferenciaSlab{-1, 0});
+        unsigned long long accesos = 0, omitidos = 0, fallidos = 0; // Fallidos: sin marco para atenderlos
+        double proxima_instantanea = metricas_activas ? config.intervalo_metricas : numeric_limits<double>::infinity();
+        
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "=== REPRODUCIENDO TRAZA: " << traza.numRegistros() << " accesos, "
+             << traza.numProcesos() << " procesos ===" << COLOR_RESET << '\n');
+        if (fusionActiva()) programarEvento(TipoEvento::ESCANEO_KSM, tiempo_simulado + config.intervalo_ksm);
+        if (config.paginas_enormes) programarEvento(TipoEvento::PROMOCION_ENORMES, tiempo_simulado + config.intervalo_promocion);
+        
+        for (uint64_t r = 0; r < traza.numRegistros(); ++r) {
+            const RegistroTraza& entrada = registros[r];
+            tiempo_simulado += entrada.delta_us * 1e-6;
+            if (tiempo_simulado >= proxima_instantanea) {
+                escribirInstantanea();
+                proxima_instantanea = tiempo_simulado + config.intervalo_metricas;
+            }
+            // Despertares del reclamador, del escáner de fusión y del promotor que ya vencieron
+            // (los únicos eventos programados en una traza)
+            while (!cola_eventos.empty() && cola_eventos.top().tiempo <= tiempo_simulado) {
+                TipoEvento tipo = cola_eventos.top().tipo;
+                cola_eventos.pop();
+                if (tipo == TipoEvento::ESCANEO_KSM) atenderEscaneoKsm();
+                else if (tipo == TipoEvento::PROMOCION_ENORMES) atenderPromocion();
+                else atenderRecuperacion();
+            }
+            ReferenciaSlab& ref = procesos_traza[entrada.proceso];
+            
+            if (ref.indice == -1) {
+                uint64_t direccion_maxima = min<uint64_t>(tabla[entrada.proceso].direccion_maxima, BYTES_ESPACIO_VIRTUAL - 1);
+                int64_t paginas_proceso = direccion_maxima / bytes_pagina + 1;
+                int indice = crearProcesoConPaginas(paginas_proceso * bytes_pagina, paginas_proceso);
+                ref = (indice == -1) ? ReferenciaSlab{-2, 0} : procesos.referencia(indice);
+            }
+            Proceso* proceso = procesos.obtener(ref);
+            if (proceso == nullptr) {
+                omitidos++;
+                continue;
+            }
+            
+            uint64_t direccion = entrada.direccion & ~TRAZA_BIT_ESCRITURA;
+            if (direccion < BYTES_ESPACIO_VIRTUAL) {
+                if (accederPagina(*proceso, direccion / bytes_pagina, entrada.direccion & TRAZA_BIT_ESCRITURA)) accesos++;
+                else fallidos++;
+            } else {
+                omitidos++;
+            }
+            
+            if (tabla[entrada.proceso].ultimo_registro == r) {
+                finalizarProceso(ref.indice);
+            }
+        }
+        
+        if (almacen_swap) almacen_swap->vaciar();
+        duracion_real = chrono::duration<double>(chrono::steady_clock::now() - inicio_real).count();
+        if (metricas_activas) escribirInstantanea();
+        mostrarEstadisticasFinales();
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Accesos reproducidos: " << accesos << " (omitidos: " << omitidos
+             << ", fallidos: " << fallidos << ")" << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Tiempo real: " << duracion_real << " s ("
+             << (duracion_real > 0 ? accesos / duracion_real : 0.0) << " accesos/s)" << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "============================" << COLOR_RESET << '\n');
+        registro.vaciar();
+    }
+
+    // Guarda o restaura todo lo que cambia durante la simulación, en el orden del archivo
+    // de estado. Lo que se deriva de la configuración (marcas, generador de carga,
+    // registro) se vuelve a armar en el constructor.
+    template <class Archivo>
+    void serializarEstado(Archivo& archivo) {
+        marcos_ram.serializar(archivo);
+        marcos_swap.serializar(archivo);
+        politica.serializar(archivo);
+        tlb.serializar(archivo);
+        procesos.serializar(archivo);
+        paginas.serializar(archivo);
+        archivo.arreglo(procesos_activos);
+        archivo.valor(siguiente_pid);
+        archivo.valor(siguiente_id_pagina);
+        archivo.valor(memoria_virtual_mb);
+        archivo.valor(accesos_memoria);
+        archivo.valor(fallos_pagina);
+        archivo.valor(procesos_creados);
+        archivo.valor(procesos_finalizados);
+        
+        // El generador se guarda en su forma de texto estándar (portable entre bibliotecas)
+        string estado_generador;
+        if constexpr (!Archivo::LECTURA) {
+            ostringstream salida;
+            salida << generador_aleatorio;
+            estado_generador = salida.str();
+        }
+        archivo.texto(estado_generador);
+        if constexpr (Archivo::LECTURA) {
+            istringstream entrada(estado_generador);
+            entrada >> generador_aleatorio;
+        }
+        
+        archivo.valor(metricas);
+        archivo.valor(recuperacion_pendiente);
+        archivo.arreglo(paginas_biblioteca);
+        archivo.valor(cursor_promocion);
+        archivo.valor(region_promocion);
+        vector<ReferenciaSlab> suspendidos(procesos_suspendidos.begin(), procesos_suspendidos.end());
+        archivo.arreglo(suspendidos);
+        archivo.valor(llegadas_diferidas);
+        archivo.arreglo(ultima_referencia);
+        
+        // Cola de eventos en orden de atención; al restaurar el montículo se rearma (el
+        // desempate por secuencia hace que el orden resultante sea el mismo)
+        vector<Evento> eventos;
+        if constexpr (!Archivo::LECTURA) {
+            auto pendientes = cola_eventos;
+            eventos.reserve(pendientes.size());
+            for (; !pendientes.empty(); pendientes.pop()) eventos.push_back(pendientes.top());
+        }
+        archivo.arreglo(eventos);
+        archivo.valor(tiempo_simulado);
+        archivo.valor(secuencia_eventos);
+        archivo.valor(eventos_procesados);
+        
+        if constexpr (Archivo::LECTURA) {
+            procesos_suspendidos.assign(suspendidos.begin(), suspendidos.end());
+            cola_eventos = decltype(cola_eventos)(greater<Evento>(), move(eventos));
+        }
+    }
+    
+    // Guarda el estado completo (configuración incluida) para continuarlo después
+    bool guardarEstado(const string& ruta, string& error) {
+        auto inicio = chrono::steady_clock::now();
+        EscritorEstado escritor;
+        if (!escritor.abrir(ruta)) {
+            error = "no se pudo crear " + ruta;
+            return false;
+        }
+        // La configuración guardada reproduce la misma memoria virtual y no arrastra los
+        // archivos de salida de esta ejecución
+        ConfiguracionSimulacion guardada = config;
+        guardada.factor_virtual = factor_memoria_virtual;
+        guardada.archivo_registro_binario.clear();
+        guardada.archivo_registro.clear();
+        guardada.prefijo_metricas.clear();
+        guardada.archivo_barrido.clear();
+        guardada.archivo_resultados.clear();
+        guardada.archivo_guardar_estado.clear();
+        guardada.archivo_restaurar_estado.clear();
+        serializarConfiguracion(escritor, guardada);
+        serializarEstado(escritor);
+        uint64_t bytes = escritor.bytes();
+        if (!escritor.cerrar()) {
+            error = "error al escribir " + ruta;
+            return false;
+        }
+        double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Estado guardado en " << ruta << ": t = " << tiempo_simulado
+             << " s, " << procesos.size() << " procesos, " << paginas.size() << " páginas (" << bytes / 1048576.0
+             << " MB en " << segundos * 1000 << " ms)" << COLOR_RESET << '\n');
+        return true;
+    }
+    
+    // Reemplaza el estado recién construido por el de un archivo. La configuración del
+    // simulador debe coincidir con la guardada en las opciones de opcionEstadoDistinta;
+    // con otra semilla el generador se vuelve a sembrar (otra continuación del mismo estado).
+    bool restaurarEstado(const string& ruta, string& error) {
+        auto inicio = chrono::steady_clock::now();
+        LectorEstado lector;
+        if (!lector.abrir(ruta)) {
+            error = lector.obtenerError();
+            return false;
+        }
+        ConfiguracionSimulacion guardada;
+        serializarConfiguracion(lector, guardada);
+        string opcion = lector.valido() ? opcionEstadoDistinta(guardada, config) : "";
+        if (!opcion.empty()) {
+            error = "la opción " + opcion + " no puede cambiar al restaurar un estado";
+            return false;
+        }
+        serializarEstado(lector);
+        if (!lector.completo()) {
+            error = lector.valido() ? "el estado tiene datos de más" : lector.obtenerError();
+            return false;
+        }
+        if (config.semilla != guardada.semilla) generador_aleatorio.seed(config.semilla);
+        
+        // Las instantáneas de métricas siguen la configuración actual, no la guardada
+        vector<Evento> eventos;
+        for (; !cola_eventos.empty(); cola_eventos.pop()) {
+            if (cola_eventos.top().tipo != TipoEvento::INSTANTANEA_METRICAS || metricas_activas) eventos.push_back(cola_eventos.top());
+        }
+        bool con_instantanea = any_of(eventos.begin(), eventos.end(),
+                                      [](const Evento& e) { return e.tipo == TipoEvento::INSTANTANEA_METRICAS; });
+        cola_eventos = decltype(cola_eventos)(greater<Evento>(), move(eventos));
+        if (metricas_activas && !con_instantanea) {
+            metricas.tiempo_anterior = tiempo_simulado;
+            metricas.accesos_anteriores = accesos_memoria;
+            metricas.fallos_anteriores = fallos_pagina;
+            programarEvento(TipoEvento::INSTANTANEA_METRICAS, tiempo_simulado + config.intervalo_metricas);
+        }
+        restaurado = true;
+        
+        double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Estado restaurado de " << ruta << ": t = " << tiempo_simulado
+             << " s, " << procesos.size() << " procesos, " << paginas.size() << " páginas (" << lector.bytes() / 1048576.0
+             << " MB en " << segundos * 1000 << " ms)" << COLOR_RESET << '\n');
+        return true;
+    }
+
+    // Crea la serie de tiempo CSV de las métricas (prefijo.csv) con su encabezado
+    void abrirMetricas() {
+        string ruta = config.prefijo_metricas + ".csv";
+        csv_metricas = fopen(ruta.c_str(), "w");
+        if (csv_metricas == nullptr) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_ERROR << "No se pudo crear " << ruta << COLOR_RESET << '\n');
+            return;
+        }
+        fprintf(csv_metricas, "tiempo,accesos,fallos,tasa_fallos_intervalo,fallos_por_segundo,expulsiones,"
+                              "swap_in_paginas,swap_out_paginas,ram_usada,swap_usada,procesos,"
+                              "costo_fallo_p50,costo_fallo_p99\n");
+    }
+    
+    // Toma una instantánea de las métricas: una fila en prefijo.csv y el estado completo
+    // en prefijo.prom (formato de texto de Prometheus). Todo sale de contadores al vuelo;
+    // solo el detalle por proceso recorre los procesos activos.
+    void escribirInstantanea() {
+        unsigned long long accesos_intervalo = accesos_memoria - metricas.accesos_anteriores;
+        unsigned long long fallos_intervalo = fallos_pagina - metricas.fallos_anteriores;
+        double segundos_intervalo = tiempo_simulado - metricas.tiempo_anterior;
+        if (csv_metricas != nullptr) {
+            fprintf(csv_metricas, "%.6f,%llu,%llu,%.6f,%.6f,%llu,%llu,%llu,%zu,%zu,%zu,%llu,%llu\n",
+                    tiempo_simulado, accesos_memoria, fallos_pagina,
+                    accesos_intervalo ? double(fallos_intervalo) / accesos_intervalo : 0.0,
+                    segundos_intervalo > 0 ? fallos_intervalo / segundos_intervalo : 0.0,
+                    metricas.expulsiones, metricas.swap_in, metricas.swap_out,
+                    marcos_ram.usados(), marcos_swap.usados(), procesos_activos.size(),
+                    static_cast<unsigned long long>(metricas.costo_fallo.cuantil(0.5)),
+                    static_cast<unsigned long long>(metricas.costo_fallo.cuantil(0.99)));
+        }
+        metricas.tiempo_anterior = tiempo_simulado;
+        metricas.accesos_anteriores = accesos_memoria;
+        metricas.fallos_anteriores = fallos_pagina;
+        escribirPrometheus();
+    }
+    
+    // Escribe prefijo.prom de forma atómica (archivo temporal + rename), así quien lo lea
+    // nunca ve un archivo a medio escribir
+    void escribirPrometheus() {
+        string ruta = config.prefijo_metricas + ".prom";
+        string temporal = ruta + ".tmp";
+        FILE* archivo = fopen(temporal.c_str(), "w");
+        if (archivo == nullptr) return;
+        
+        auto metrica = [archivo](const char* nombre, const char* tipo, const char* ayuda, double valor) {
+            fprintf(archivo, "# HELP %s %s\n# TYPE %s %s\n%s %.17g\n", nombre, ayuda, nombre, tipo, nombre, valor);
+        };
+        metrica("simulador_tiempo_simulado_segundos", "gauge", "Reloj simulado", tiempo_simulado);
+        metrica("simulador_accesos_total", "counter", "Accesos a paginas", accesos_memoria);
+        metrica("simulador_fallos_pagina_total", "counter", "Fallos de pagina", fallos_pagina);
+        metrica("simulador_expulsiones_total", "counter", "Paginas desalojadas de RAM", metricas.expulsiones);
+        metrica("simulador_swap_in_bytes_total", "counter", "Bytes traidos desde SWAP",
+                double(metricas.swap_in) * bytes_pagina);
+        metrica("simulador_swap_out_bytes_total", "counter", "Bytes enviados a SWAP",
+                double(metricas.swap_out) * bytes_pagina);
+        metrica("simulador_expulsiones_fondo_total", "counter", "Paginas expulsadas por el reclamador en segundo plano",
+                metricas.expulsiones_fondo);
+        metrica("simulador_recuperacion_directa_total", "counter", "Fallos que expulsaron en linea por falta de marcos",
+                metricas.recuperacion_directa);
+        metrica("simulador_anticipadas_total", "counter", "Paginas traidas por lectura anticipada", metricas.anticipadas);
+        metrica("simulador_anticipadas_usadas_total", "counter", "Paginas anticipadas que se usaron",
+                metricas.aciertos_anticipados);
+        metrica("simulador_anticipadas_sin_uso_total", "counter", "Paginas anticipadas descartadas sin usar",
+                metricas.anticipadas_sin_uso);
+        if (cache_comprimida) {
+            metrica("simulador_zswap_guardadas_total", "counter", "Paginas guardadas en la cache comprimida",
+                    cache_comprimida->numGuardadas());
+            metrica("simulador_zswap_aciertos_total", "counter", "Swap-in servidos desde la cache comprimida",
+                    cache_comprimida->numAciertos());
+            metrica("simulador_zswap_devueltas_total", "counter", "Paginas devueltas de la cache al archivo",
+                    cache_comprimida->numDevueltas());
+            metrica("simulador_zswap_pool_bytes", "gauge", "Bytes de la arena en uso", cache_comprimida->bytesPool());
+            metrica("simulador_zswap_razon_compresion", "gauge", "Bytes originales / comprimidos",
+                    cache_comprimida->razonCompresion());
+        }
+        metrica("simulador_paginas_compartidas", "gauge", "Paginas que usan el marco o la ranura de otra",
+                metricas.paginas_compartidas);
+        metrica("simulador_forks_total", "counter", "Procesos creados como fork", metricas.forks);
+        metrica("simulador_copias_escritura_total", "counter", "Paginas compartidas copiadas al escribirlas",
+                metricas.copias_escritura);
+        metrica("simulador_tabla_nodos", "gauge", "Nodos de las tablas de paginas radix de los procesos vivos",
+                metricas.nodos_tabla);
+        metrica("simulador_fallos_demanda_total", "counter", "Paginas creadas en su primer acceso", metricas.fallos_demanda);
+        if (config.paginas_enormes) {
+            metrica("simulador_enormes", "gauge", "Paginas enormes mapeadas", metricas.regiones_enormes);
+            metrica("simulador_enormes_mapeadas_total", "counter", "Regiones mapeadas como pagina enorme al crearse",
+                    metricas.enormes_mapeadas);
+            metrica("simulador_enormes_promovidas_total", "counter", "Regiones promovidas a pagina enorme",
+                    metricas.enormes_promovidas);
+            metrica("simulador_enormes_divididas_total", "counter", "Paginas enormes divididas en paginas base",
+                    metricas.enormes_divididas);
+        }
+        if (config.ventana_trabajo > 0) {
+            metrica("simulador_demanda_trabajo_marcos", "gauge", "Suma de los conjuntos de trabajo de los procesos activos",
+                    metricas.demanda_trabajo);
+            metrica("simulador_procesos_suspendidos", "gauge", "Procesos suspendidos por el control de carga",
+                    procesos_suspendidos.size());
+            metrica("simulador_llegadas_diferidas", "gauge", "Llegadas esperando lugar en RAM", llegadas_diferidas);
+            metrica("simulador_suspensiones_total", "counter", "Procesos suspendidos", metricas.suspensiones);
+            metrica("simulador_reanudaciones_total", "counter", "Procesos reanudados", metricas.reanudaciones);
+            metrica("simulador_rendimiento_estimado", "gauge", "Accesos por segundo estimados", rendimientoEstimado());
+        }
+        if (fusionActiva()) {
+            metrica("simulador_ksm_fusiones_total", "counter", "Paginas iguales fusionadas", metricas.fusiones_ksm);
+            metrica("simulador_ksm_revisadas_total", "counter", "Paginas revisadas por el escaner de fusion",
+                    metricas.revisadas_ksm);
+        }
+        metrica("simulador_procesos_creados_total", "counter", "Procesos creados", procesos_creados);
+        metrica("simulador_procesos_finalizados_total", "counter", "Procesos finalizados", procesos_finalizados);
+        metrica("simulador_ram_marcos_usados", "gauge", "Marcos de RAM ocupados", marcos_ram.usados());
+        metrica("simulador_ram_marcos_total", "gauge", "Marcos de RAM", marcos_ram.total());
+        metrica("simulador_swap_marcos_usados", "gauge", "Marcos de SWAP ocupados", marcos_swap.usados());
+        metrica("simulador_swap_marcos_total", "gauge", "Marcos de SWAP", marcos_swap.total());
+        
+        // Histograma acumulado del costo de los fallos (hasta la última cubeta con datos)
+        const HistogramaLog2& costo = metricas.costo_fallo;
+        fprintf(archivo, "# HELP simulador_costo_fallo Costo de atender un fallo (ciclos TSC o ns)\n"
+                         "# TYPE simulador_costo_fallo histogram\n");
+        int ultima = 0;
+        for (int i = 0; i < HistogramaLog2::NUM_CUBETAS - 1; ++i) if (costo.cubeta(i)) ultima = i;
+        unsigned long long acumulado = 0;
+        for (int i = 0; i <= ultima && costo.numValores() > 0; ++i) {
+            acumulado += costo.cubeta(i);
+            fprintf(archivo, "simulador_costo_fallo_bucket{le=\"%llu\"} %llu\n",
+                    static_cast<unsigned long long>(HistogramaLog2::limiteSuperior(i)), acumulado);
+        }
+        fprintf(archivo, "simulador_costo_fallo_bucket{le=\"+Inf\"} %llu\n", costo.numValores());
+        fprintf(archivo, "simulador_costo_fallo_sum %llu\nsimulador_costo_fallo_count %llu\n",
+                costo.sumaValores(), costo.numValores());
+        
+        // Páginas residentes y en SWAP de cada proceso activo
+        fprintf(archivo, "# HELP simulador_proceso_paginas Paginas de cada proceso segun ubicacion\n"
+                         "# TYPE simulador_proceso_paginas gauge\n");
+        for (ReferenciaSlab ref : procesos_activos) {
+            const Proceso& proceso = procesos[ref.indice];
+            fprintf(archivo, "simulador_proceso_paginas{pid=\"%d\",ubicacion=\"ram\"} %d\n",
+                    proceso.pid, proceso.paginas_residentes);
+            fprintf(archivo, "simulador_proceso_paginas{pid=\"%d\",ubicacion=\"swap\"} %lld\n",
+                    proceso.pid, static_cast<long long>(proceso.paginas_mapeadas - proceso.paginas_residentes));
+        }
+        fclose(archivo);
+        rename(temporal.c_str(), ruta.c_str());
+    }
+
+    // Resultado de la última ejecución (para barridos de parámetros)
+    ResultadoSimulacion obtenerResultado() const {
+        ResultadoSimulacion resultado;
+        resultado.marcos_ram = marcos_ram.total();
+        resultado.marcos_swap = marcos_swap.total();
+        resultado.memoria_virtual_mb = memoria_virtual_mb;
+        resultado.procesos_creados = procesos_creados;
+        resultado.procesos_finalizados = procesos_finalizados;
+        resultado.accesos = accesos_memoria;
+        resultado.fallos_pagina = fallos_pagina;
+        resultado.paginas_creadas = siguiente_id_pagina - 1;
+        resultado.eventos_procesados = eventos_procesados;
+        resultado.tiempo_simulado = tiempo_simulado;
+        resultado.tiempo_real = duracion_real;
+        resultado.tlb_aciertos = tlb.numAciertos();
+        resultado.tlb_fallos = tlb.numFallos();
+        resultado.tlb_derribos = tlb.numDerribos();
+        resultado.expulsiones = metricas.expulsiones;
+        resultado.anticipadas = metricas.anticipadas;
+        resultado.aciertos_anticipados = metricas.aciertos_anticipados;
+        resultado.anticipadas_sin_uso = metricas.anticipadas_sin_uso;
+        resultado.expulsiones_anticipacion = metricas.expulsiones_anticipacion;
+        resultado.expulsiones_fondo = metricas.expulsiones_fondo;
+        resultado.recuperacion_directa = metricas.recuperacion_directa;
+        if (cache_comprimida) {
+            resultado.zswap_aciertos = cache_comprimida->numAciertos();
+            resultado.zswap_devueltas = cache_comprimida->numDevueltas();
+            resultado.razon_compresion = cache_comprimida->razonCompresion();
+        }
+        resultado.forks = metricas.forks;
+        resultado.copias_escritura = metricas.copias_escritura;
+        resultado.fusiones_ksm = metricas.fusiones_ksm;
+        resultado.compartidas_pico = metricas.compartidas_pico;
+        resultado.fallos_demanda = metricas.fallos_demanda;
+        resultado.enormes_mapeadas = metricas.enormes_mapeadas;
+        resultado.enormes_promovidas = metricas.enormes_promovidas;
+        resultado.enormes_divididas = metricas.enormes_divididas;
+        resultado.nodos_tabla_pico = metricas.nodos_tabla_pico;
+        resultado.demanda_pico = metricas.demanda_pico;
+        resultado.sobrecargas = metricas.sobrecargas;
+        resultado.suspensiones = metricas.suspensiones;
+        resultado.reanudaciones = metricas.reanudaciones;
+        resultado.llegadas_diferidas = metricas.llegadas_diferidas;
+        resultado.rendimiento = rendimientoEstimado();
+        return resultado;
+    }
+
+    // Estadísticas comunes a la simulación sintética y a la reproducción de trazas
+    void mostrarEstadisticasFinales() {
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "\n=== ESTADÍSTICAS FINALES ===" << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Procesos creados: " << procesos_creados << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Procesos finalizados: " << procesos_finalizados << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Fallos de página: " << fallos_pagina << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Páginas totales creadas: " << (siguiente_id_pagina - 1) << COLOR_RESET << '\n');
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Ranuras reservadas (pico): " << procesos.capacidad() << " procesos, "
+             << paginas.capacidad() << " páginas" << COLOR_RESET << '\n');
+        if (tlb.activa()) {
+            unsigned long long consultas = tlb.numAciertos() + tlb.numFallos();
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "TLB: " << tlb.numAciertos() << " aciertos, "
+                 << tlb.numFallos() << " fallos (" << (consultas ? 100.0 * tlb.numAciertos() / consultas : 0.0)
+                 << "% aciertos), " << tlb.numDerribos() << " derribos, " << tlb.numVaciados() << " vaciados"
+                 << COLOR_RESET << '\n');
+        }
+        if (config.paginacion_demanda || config.paginas_enormes) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Tablas de páginas radix: " << metricas.nodos_tabla_pico
+                 << " nodos en el pico (" << metricas.nodos_tabla_pico * TablaRadix::ENTRADAS * sizeof(int) / 1024
+                 << " KB) | fallos por primer toque: " << metricas.fallos_demanda << COLOR_RESET << '\n');
+        }
+        if (config.paginas_enormes) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Páginas enormes (" << textoTamano(PAGINAS_ENORME * bytes_pagina)
+                 << "): " << metricas.enormes_mapeadas << " mapeadas al crearse, " << metricas.enormes_promovidas
+                 << " promovidas, " << metricas.enormes_divididas << " divididas, " << metricas.promociones_sin_bloque
+                 << " promociones sin bloque libre, " << metricas.regiones_enormes << " al final" << COLOR_RESET << '\n');
+        }
+        if (config.ventana_trabajo > 0) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Control de carga" << (config.control_carga ? "" : " (solo medición)")
+                 << ": demanda pico " << metricas.demanda_pico << " de " << marcos_ram.total() << " marcos, sobrecarga en "
+                 << metricas.sobrecargas << " de " << metricas.revisiones_control << " revisiones | suspensiones: "
+                 << metricas.suspensiones << " (" << metricas.paginas_suspendidas << " páginas a SWAP), reanudaciones: "
+                 << metricas.reanudaciones << ", suspendidos al final: " << procesos_suspendidos.size()
+                 << " | llegadas diferidas: " << metricas.llegadas_diferidas << " (" << llegadas_diferidas << " esperando)"
+                 << COLOR_RESET << '\n');
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Rendimiento estimado: " << rendimientoEstimado()
+                 << " accesos/s con " << (accesos_memoria ? 100.0 * fallos_pagina / accesos_memoria : 0.0)
+                 << "% de fallos (acceso de " << TIEMPO_ACCESO_US << " us, página con SWAP de " << config.costo_swap_us
+                 << " us)" << COLOR_RESET << '\n');
+        }
+        if (marca_alta > 0) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Recuperación en segundo plano: " << metricas.despertares_recuperacion
+                 << " despertares, " << metricas.expulsiones_fondo << " páginas expulsadas | fallos con recuperación directa: "
+                 << metricas.recuperacion_directa << " de " << fallos_pagina << " ("
+                 << (fallos_pagina ? 100.0 * metricas.recuperacion_directa / fallos_pagina : 0.0) << "%)" << COLOR_RESET << '\n');
+        }
+        if (config.probabilidad_fork > 0 || config.paginas_biblioteca > 0 || fusionActiva()) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Páginas compartidas: " << metricas.paginas_compartidas
+                 << " al final, pico " << metricas.compartidas_pico << " (marcos ahorrados) | forks: " << metricas.forks
+                 << " | copias en escritura: " << metricas.copias_escritura << COLOR_RESET << '\n');
+        }
+        if (fusionActiva()) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Fusión de páginas iguales (KSM): " << metricas.fusiones_ksm
+                 << " fusiones, " << metricas.revisadas_ksm << " páginas revisadas en " << metricas.pasadas_ksm
+                 << " pasadas completas" << COLOR_RESET << '\n');
+        }
+        if (config.paginas_anticipacion > 0) {
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Lectura anticipada (" << config.modo_anticipacion
+                 << ", hasta " << config.paginas_anticipacion << " páginas): " << metricas.anticipadas << " páginas, "
+                 << metricas.aciertos_anticipados << " usadas ("
+                 << (metricas.anticipadas ? 100.0 * metricas.aciertos_anticipados / metricas.anticipadas : 0.0)
+                 << "%), " << metricas.anticipadas_sin_uso << " descartadas sin usar, "
+                 << metricas.expulsiones_anticipacion << " expulsiones causadas" << COLOR_RESET << '\n');
+        }
+        if (almacen_swap) {
+            const AlmacenSwap& swap = *almacen_swap;
+            double mb_leidos = swap.numPaginasLeidas() * (swap.bytesPagina() / 1048576.0);
+            double mb_escritos = swap.numPaginasEscritas() * (swap.bytesPagina() / 1048576.0);
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "SWAP en archivo - lecturas: " << swap.numLecturas()
+                 << " (" << swap.numPaginasLeidas() << " páginas, +" << swap.numLecturasLote()
+                 << " desde lotes en memoria), latencia p50 <= "
+                 << swap.latenciaLectura().cuantil(0.5) << " us, p99 <= " << swap.latenciaLectura().cuantil(0.99)
+                 << " us, " << (swap.segundosLectura() > 0 ? mb_leidos / swap.segundosLectura() : 0.0) << " MB/s"
+                 << COLOR_RESET << '\n');
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "SWAP en archivo - escrituras: " << swap.numEscrituras()
+                 << " (" << swap.numPaginasEscritas() << " páginas, "
+                 << (swap.numEscrituras() ? double(swap.numPaginasEscritas()) / swap.numEscrituras() : 0.0)
+                 << " por escritura), latencia p50 <= " << swap.latenciaEscritura().cuantil(0.5) << " us, p99 <= "
+                 << swap.latenciaEscritura().cuantil(0.99) << " us, "
+                 << (swap.segundosEscritura() > 0 ? mb_escritos / swap.segundosEscritura() : 0.0) << " MB/s"
+                 << COLOR_RESET << '\n');
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "SWAP en archivo - errores de E/S: " << swap.numErrores()
+                 << " | páginas con contenido incorrecto: " << errores_contenido << COLOR_RESET << '\n');
+        }
+        if (cache_comprimida) {
+            const CacheComprimida& cache = *cache_comprimida;
+            unsigned long long swap_in = cache.numAciertos() + cache.numFallos();
+            double mb_comprimidos = cache.bytesOriginales() / 1048576.0;
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Caché comprimida - guardadas: " << cache.numGuardadas()
+                 << " (razón " << cache.razonCompresion() << ":1), incompresibles al archivo: " << cache.numIncompresibles()
+                 << ", devueltas al archivo por antigüedad: " << cache.numDevueltas() << COLOR_RESET << '\n');
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Caché comprimida - swap-in desde la caché: " << cache.numAciertos()
+                 << " de " << swap_in << " (" << (swap_in ? 100.0 * cache.numAciertos() / swap_in : 0.0) << "%), pool: "
+                 << cache.bytesPool() / 1048576.0 << " de " << cache.bytesPresupuesto() / 1048576.0 << " MB ("
+                 << cache.paginasGuardadas() << " páginas, " << cache.bytesGuardados() / 1048576.0 << " MB comprimidos)"
+                 << COLOR_RESET << '\n');
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Caché comprimida - CPU: compresión " << cache.segundosCompresion()
+                 << " s (" << (cache.segundosCompresion() > 0 ? mb_comprimidos / cache.segundosCompresion() : 0.0)
+                 << " MB/s de páginas aceptadas), descompresión " << cache.segundosDescompresion() << " s, errores: "
+                 << cache.numErrores() << COLOR_RESET << '\n');
+        }
+        if (metricas_activas) {
+            double mb_pagina = bytes_pagina / 1048576.0;
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Expulsiones: " << metricas.expulsiones
+                 << " | Swap-in: " << metricas.swap_in * mb_pagina << " MB | Swap-out: "
+                 << metricas.swap_out * mb_pagina << " MB" << COLOR_RESET << '\n');
+            REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Costo de fallo (ciclos, cubetas log2): p50 <= "
+                 << metricas.costo_fallo.cuantil(0.5) << " | p90 <= " << metricas.costo_fallo.cuantil(0.9)
+                 << " | p99 <= " << metricas.costo_fallo.cuantil(0.99) << COLOR_RESET << '\n');
+        }
+        REGISTRAR(registro, NivelRegistro::RESUMEN, COLOR_INFO << "Tiempo total de simulación: " << tiempo_simulado << " segundos simulados" << COLOR_RESET << '\n');
+    }
+};
+
+// ============================================================================
+// SIMULACIÓN CONCURRENTE
+// ============================================================================
+
+// Mapa de bits de marcos libres sin cerrojos (bit en 1 = marco libre). Asignar apaga
+// un bit con compare_exchange y liberar lo enciende con fetch_or. Cada hilo empieza a
+// buscar en una palabra distinta para no competir siempre por la misma.
+class AsignadorMarcosAtomico {
+private:
+    vector<atomic<uint64_t>> palabras;
+    size_t total;
+
+public:
+    AsignadorMarcosAtomico() : total(0) {}
+
+    void inicializar(size_t num_marcos) {
+        total = num_marcos;
+        palabras = vector<atomic<uint64_t>>((num_marcos + 63) / 64);
+        for (size_t p = 0; p < palabras.size(); ++p) {
+            size_t bits = min<size_t>(64, num_marcos - p * 64);
+            palabras[p].store(bits == 64 ? ~0ULL : (1ULL << bits) - 1, memory_order_relaxed);
+        }
+    }
+
+    // Asigna algún marco libre empezando por la palabra de la pista (-1 si no hay).
+    // Cuenta en reintentos los compare_exchange perdidos contra otros hilos.
+    int asignar(size_t pista, unsigned long long& reintentos) {
+        for (size_t paso = 0; paso < palabras.size(); ++paso) {
+            size_t p = (pista + paso) % palabras.size();
+            uint64_t valor = palabras[p].load(memory_order_relaxed);
+            while (valor != 0) {
+                int bit = __builtin_ctzll(valor);
+                if (palabras[p].compare_exchange_weak(valor, valor & ~(1ULL << bit), memory_order_acquire)) {
+                    return static_cast<int>(p * 64 + bit);
+                }
+                reintentos++;
+            }
+        }
+        return -1;
+    }
+
+    void liberar(int marco) {
+        palabras[marco / 64].fetch_or(1ULL << (marco % 64), memory_order_release);
+    }
+
+    bool libre(int marco) const {
+        return (palabras[marco / 64].load(memory_order_acquire) >> (marco % 64)) & 1;
+    }
+
+    size_t libres() const {
+        size_t cuenta = 0;
+        for (const atomic<uint64_t>& palabra : palabras) cuenta += __builtin_popcountll(palabra.load());
+        return cuenta;
+    }
+
+    size_t numPalabras() const { return palabras.size(); }
+};
+
+// Proceso del modo concurrente. Su tabla de páginas es su propio fragmento: solo su
+// hilo carga páginas en ella, y los demás hilos solo la tocan para expulsar una página.
+struct alignas(64) ProcesoConcurrente {
+    int pid = 0;
+    int num_paginas = 0;
+    vector<atomic<uint64_t>> ptes;  // PRESENTE | marco de RAM; 0 = página en SWAP
+    EstadoCarga carga;
+    mt19937 generador;
+};
+
+// Contadores de un hilo (alineados para no compartir línea de caché con otro hilo)
+struct alignas(64) EstadisticasHilo {
+    unsigned long long accesos = 0;
+    unsigned long long fallos = 0;
+    unsigned long long expulsiones = 0;
+    unsigned long long liberadas = 0;
+    unsigned long long reintentos = 0; // Compare_exchange perdidos y esperas por marcos bloqueados
+};
+
+// Simulador en el que cada grupo de procesos corre en su propio hilo, como en un
+// kernel SMP. El reemplazo es Clock sobre bits de referencia atómicos. Cada marco
+// tiene un estado atómico (0 = libre, o clave del dueño + 1) con un bit de bloqueo
+// que toma quien lo expulsa o libera, así dos hilos nunca se quedan con el mismo
+// marco. SWAP se considera ilimitado: una página no presente está en SWAP.
+class SimuladorConcurrente {
+private:
+    static constexpr uint64_t PTE_PRESENTE = 1ULL << 63;
+    static constexpr uint64_t MARCO_BLOQUEADO = 1ULL << 63;
+    static constexpr int VIDAS_POR_PROCESO = 4; // Cada proceso termina y se recrea entre vidas
+
+    ConfiguracionSimulacion config;
+    GeneradorCarga generador_carga;
+    size_t num_hilos;
+    
+    AsignadorMarcosAtomico libres;                  // Marcos de RAM libres
+    vector<atomic<uint64_t>> estado_marco;          // Dueño de cada marco (clave + 1) y bloqueo
+    vector<atomic<uint8_t>> referencia;             // Bits de referencia de Clock
+    atomic<size_t> manecilla;                       // Manecilla de Clock compartida
+    vector<ProcesoConcurrente> procesos;
+    vector<EstadisticasHilo> estadisticas;
+
+    static uint64_t clave(size_t proceso, int pagina) { return (static_cast<uint64_t>(proceso) << 32) | pagina; }
+
+    // Expulsa la página de un marco según Clock y retorna el marco bloqueado (-1 si
+    // no encontró víctima en dos vueltas, por ejemplo si otros hilos los tienen tomados)
+    int expulsarVictima(EstadisticasHilo& estadistica) {
+        size_t num_marcos = estado_marco.size();
+        for (size_t paso = 0; paso < 2 * num_marcos; ++paso) {
+            size_t marco = manecilla.fetch_add(1, memory_order_relaxed) % num_marcos;
+            uint64_t estado = estado_marco[marco].load(memory_order_acquire);
+            if (estado == 0 || (estado & MARCO_BLOQUEADO)) continue;
+            if (referencia[marco].exchange(0, memory_order_relaxed)) continue; // Segunda oportunidad
+            if (!estado_marco[marco].compare_exchange_strong(estado, estado | MARCO_BLOQUEADO, memory_order_acq_rel)) {
+                estadistica.reintentos++;
+                continue;
+            }
+            // Con el marco bloqueado, quitar la página de la tabla de su dueño (pasa a SWAP)
+            uint64_t victima = estado - 1;
+            procesos[victima >> 32].ptes[victima & 0xffffffffu].store(0, memory_order_release);
+            estadistica.expulsiones++;
+            return static_cast<int>(marco);
+        }
+        return -1;
+    }
+
+    // Atiende un acceso del proceso (hilo dueño del proceso)
+    void acceder(size_t indice, int pagina, size_t hilo, EstadisticasHilo& estadistica) {
+        ProcesoConcurrente& proceso = procesos[indice];
+        estadistica.accesos++;
+        uint64_t pte = proceso.ptes[pagina].load(memory_order_acquire);
+        if (pte & PTE_PRESENTE) {
+            // Si otro hilo la expulsa justo después, el acceso ocurrió antes: como una TLB
+            referencia[pte & ~PTE_PRESENTE].store(1, memory_order_relaxed);
+            return;
+        }
+        
+        // Fallo de página: un marco libre o, si no hay, uno expulsado
+        estadistica.fallos++;
+        size_t pista = hilo * libres.numPalabras() / num_hilos;
+        int marco = libres.asignar(pista, estadistica.reintentos);
+        while (marco == -1) {
+            marco = expulsarVictima(estadistica);
+            if (marco == -1) marco = libres.asignar(pista, estadistica.reintentos);
+        }
+        
+        // Publicar primero la PTE y después el dueño: quien vea el dueño ya ve la PTE
+        proceso.ptes[pagina].store(PTE_PRESENTE | marco, memory_order_release);
+        referencia[marco].store(1, memory_order_relaxed);
+        estado_marco[marco].store(clave(indice, pagina) + 1, memory_order_release);
+    }
+
+    // Libera todas las páginas del proceso (fin de una vida del proceso)
+    void finalizar(size_t indice, EstadisticasHilo& estadistica) {
+        ProcesoConcurrente& proceso = procesos[indice];
+        for (int pagina = 0; pagina < proceso.num_paginas; ++pagina) {
+            while (true) {
+                uint64_t pte = proceso.ptes[pagina].load(memory_order_acquire);
+                if (!(pte & PTE_PRESENTE)) break; // En SWAP (o recién expulsada)
+                int marco = static_cast<int>(pte & ~PTE_PRESENTE);
+                uint64_t esperado = clave(indice, pagina) + 1;
+                if (estado_marco[marco].compare_exchange_strong(esperado, esperado | MARCO_BLOQUEADO, memory_order_acq_rel)) {
+                    proceso.ptes[pagina].store(0, memory_order_release);
+                    estado_marco[marco].store(0, memory_order_release);
+                    libres.liberar(marco);
+                    estadistica.liberadas++;
+                    break;
+                }
+                // Otro hilo está expulsando esta página: esperar a que limpie la PTE
+                estadistica.reintentos++;
+                this_thread::yield();
+            }
+        }
+    }
+
+    // Recorre los procesos del hilo por turnos hasta completar sus accesos
+    void ejecutarHilo(size_t hilo) {
+        EstadisticasHilo& estadistica = estadisticas[hilo];
+        vector<size_t> grupo;
+        for (size_t p = hilo; p < procesos.size(); p += num_hilos) grupo.push_back(p);
+        long long accesos_por_vida = max(1LL, config.accesos_por_proceso / VIDAS_POR_PROCESO);
+        
+        for (long long paso = 0; paso < config.accesos_por_proceso; ++paso) {
+            for (size_t indice : grupo) {
+                ProcesoConcurrente& proceso = procesos[indice];
+                acceder(indice, generador_carga.siguientePagina(proceso.carga, proceso.num_paginas, proceso.generador),
+                        hilo, estadistica);
+                // Entre vidas el proceso termina y se vuelve a crear sin páginas en RAM
+                if ((paso + 1) % accesos_por_vida == 0 && paso + 1 < config.accesos_por_proceso) {
+                    finalizar(indice, estadistica);
+                    generador_carga.inicializarEstado(proceso.carga, proceso.num_paginas, proceso.generador);
+                }
+            }
+        }
+    }
+
+public:
+    explicit SimuladorConcurrente(const ConfiguracionSimulacion& configuracion)
+        : config(configuracion),
+          generador_carga(configuracion),
+          num_hilos(configuracion.hilos > 0 ? configuracion.hilos : max(1u, thread::hardware_concurrency())),
+          manecilla(0) {
+        size_t num_marcos = max<uint64_t>(1, config.memoria_fisica / config.tamano_pagina);
+        libres.inicializar(num_marcos);
+        estado_marco = vector<atomic<uint64_t>>(num_marcos);
+        referencia = vector<atomic<uint8_t>>(num_marcos);
+        for (size_t m = 0; m < num_marcos; ++m) {
+            estado_marco[m].store(0, memory_order_relaxed);
+            referencia[m].store(0, memory_order_relaxed);
+        }
+        
+        // Procesos con tamaño al azar; cada uno con su propio generador
+        size_t num_procesos = config.max_procesos > 0 ? config.max_procesos : 4 * num_hilos;
+        num_hilos = min(num_hilos, num_procesos);
+        procesos = vector<ProcesoConcurrente>(num_procesos);
+        mt19937 generador(config.semilla);
+        for (size_t p = 0; p < num_procesos; ++p) {
+            ProcesoConcurrente& proceso = procesos[p];
+            proceso.pid = static_cast<int>(p) + 1;
+            uint64_t tamano = sortearTamanoProceso(config, generador);
+            proceso.num_paginas = (tamano + config.tamano_pagina - 1) / config.tamano_pagina;
+            proceso.ptes = vector<atomic<uint64_t>>(proceso.num_paginas);
+            for (atomic<uint64_t>& pte : proceso.ptes) pte.store(0, memory_order_relaxed);
+            proceso.generador.seed(config.semilla + proceso.pid);
+            generador_carga.inicializarEstado(proceso.carga, proceso.num_paginas, proceso.generador);
+        }
+        estadisticas = vector<EstadisticasHilo>(num_hilos);
+    }
+
+    // Verifica los invariantes de propiedad de los marcos (con los hilos detenidos):
+    // ningún marco bloqueado, cada marco ocupado figura como usado y su dueño lo tiene
+    // en su PTE, cada PTE presente apunta a un marco que le pertenece, y el número de
+    // páginas presentes coincide con los marcos usados.
+    bool verificarInvariantes(string& error) const {
+        size_t num_marcos = estado_marco.size();
+        size_t usados = 0;
+        for (size_t m = 0; m < num_marcos; ++m) {
+            uint64_t estado = estado_marco[m].load();
+            if (estado & MARCO_BLOQUEADO) {
+                error = "marco " + to_string(m) + " quedó bloqueado";
+                return false;
+            }
+            if (estado == 0) {
+                if (!libres.libre(m)) {
+                    error = "marco " + to_string(m) + " sin dueño pero marcado como usado";
+                    return false;
+                }
+                continue;
+            }
+            usados++;
+            uint64_t dueno = estado - 1;
+            size_t proceso = dueno >> 32;
+            size_t pagina = dueno & 0xffffffffu;
+            if (libres.libre(m)) {
+                error = "marco " + to_string(m) + " con dueño pero marcado como libre";
+                return false;
+            }
+            if (proceso >= procesos.size() || pagina >= procesos[proceso].ptes.size() ||
+                procesos[proceso].ptes[pagina].load() != (PTE_PRESENTE | m)) {
+                error = "marco " + to_string(m) + " no coincide con la PTE de su dueño";
+                return false;
+            }
+        }
+        size_t presentes = 0;
+        for (size_t p = 0; p < procesos.size(); ++p) {
+            for (size_t pagina = 0; pagina < procesos[p].ptes.size(); ++pagina) {
+                uint64_t pte = procesos[p].ptes[pagina].load();
+                if (!(pte & PTE_PRESENTE)) continue;
+                presentes++;
+                uint64_t marco = pte & ~PTE_PRESENTE;
+                if (marco >= num_marcos || estado_marco[marco].load() != clave(p, pagina) + 1) {
+                    error = "PTE " + to_string(p) + "-" + to_string(pagina) + " apunta a un marco ajeno";
+                    return false;
+                }
+            }
+        }
+        if (presentes != usados || usados + libres.libres() != num_marcos) {
+            error = "cuentas de marcos inconsistentes (" + to_string(presentes) + " presentes, " +
+                    to_string(usados) + " usados, " + to_string(libres.libres()) + " libres)";
+            return false;
+        }
+        return true;
+    }
+
+    // Ejecuta todos los hilos, verifica los invariantes, libera todo y vuelve a verificar
+    bool ejecutar() {
+        cout << COLOR_INFO << "=== SIMULACIÓN CONCURRENTE ===" << COLOR_RESET << endl;
+        cout << COLOR_INFO << "Hilos: " << num_hilos << " | Procesos: " << procesos.size()
+             << " | Marcos RAM: " << estado_marco.size() << " | Accesos por proceso: "
+             << config.accesos_por_proceso << " | Carga: " << nombreModeloCarga(generador_carga.obtenerModelo())
+             << COLOR_RESET << endl;
+        
+        auto inicio_real = chrono::steady_clock::now();
+        vector<thread> hilos;
+        for (size_t h = 0; h < num_hilos; ++h) hilos.emplace_back(&SimuladorConcurrente::ejecutarHilo, this, h);
+        for (thread& hilo : hilos) hilo.join();
+        double duracion_real = chrono::duration<double>(chrono::steady_clock::now() - inicio_real).count();
+        
+        string error;
+        bool correcto = verificarInvariantes(error);
+        if (correcto) {
+            for (size_t p = 0; p < procesos.size(); ++p) finalizar(p, estadisticas[0]);
+            if (libres.libres() != estado_marco.size()) {
+                correcto = false;
+                error = "quedaron marcos usados tras finalizar todos los procesos";
+            } else {
+                correcto = verificarInvariantes(error);
+            }
+        }
+        
+        EstadisticasHilo total;
+        for (const EstadisticasHilo& estadistica : estadisticas) {
+            total.accesos += estadistica.accesos;
+            total.fallos += estadistica.fallos;
+            total.expulsiones += estadistica.expulsiones;
+            total.liberadas += estadistica.liberadas;
+            total.reintentos += estadistica.reintentos;
+        }
+        cout << COLOR_INFO << "Accesos: " << total.accesos << " | Fallos de página: " << total.fallos
+             << " (" << (total.accesos ? 100.0 * total.fallos / total.accesos : 0.0) << "%)"
+             << " | Expulsiones: " << total.expulsiones << " | Marcos liberados: " << total.liberadas
+             << COLOR_RESET << endl;
+        cout << COLOR_INFO << "Reintentos por contención: " << total.reintentos << COLOR_RESET << endl;
+        cout << COLOR_INFO << "Tiempo real: " << duracion_real << " s ("
+             << (duracion_real > 0 ? total.accesos / duracion_real : 0.0) << " accesos/s)" << COLOR_RESET << endl;
+        if (correcto) {
+            cout << COLOR_RAM << "Invariantes de marcos: correctos" << COLOR_RESET << endl;
+        } else {
+            cout << COLOR_ERROR << "Invariantes de marcos: ERROR, " << error << COLOR_RESET << endl;
+        }
+        return correcto;
+    }
+};
+
+// Ejecuta la simulación concurrente (los modelos con localidad; forzado pasa a uniforme)
+bool ejecutarSimulacionConcurrente(ConfiguracionSimulacion config) {
+    if (config.modelo_carga == ModeloCarga::FORZADO) config.modelo_carga = ModeloCarga::UNIFORME;
+    if (config.accesos_por_proceso <= 0) {
+        cout << COLOR_ERROR << "Error: --accesos debe ser positivo" << COLOR_RESET << endl;
+        return false;
+    }
+    SimuladorConcurrente simulador(config);
+    return simulador.ejecutar();
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+// Contador de fallos de caché del hardware mediante perf_event_open (solo Linux).
+// Si el sistema no lo permite (máquina virtual, perf_event_paranoid), disponible()
+// es false y los benchmarks reportan solo tiempos.
+class ContadorFallosCache {
+private:
+    int descriptor;             // Descriptor del evento de perf (-1 si no está disponible)
+
+public:
+    ContadorFallosCache() : descriptor(-1) {
+#ifdef __linux__
+        perf_event_attr atributos{};
+        atributos.type = PERF_TYPE_HARDWARE;
+        atributos.size = sizeof(atributos);
+        atributos.config = PERF_COUNT_HW_CACHE_MISSES;
+        atributos.disabled = 1;
+        atributos.exclude_kernel = 1;
+        atributos.exclude_hv = 1;
+        descriptor = syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+#endif
+    }
+
+    ~ContadorFallosCache() {
+#ifdef __linux__
+        if (descriptor != -1) close(descriptor);
+#endif
+    }
+
+    bool disponible() const { return descriptor != -1; }
+
+    void iniciar() {
+#ifdef __linux__
+        if (descriptor == -1) return;
+        ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // Detiene el conteo y retorna los fallos de caché medidos (-1 si no está disponible)
+    long long detener() {
+        long long valor = -1;
+#ifdef __linux__
+        if (descriptor == -1) return -1;
+        ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(descriptor, &valor, sizeof(valor)) != sizeof(valor)) valor = -1;
+#endif
+        return valor;
+    }
+};
+
+// Resultado de medir una operación de benchmark
+struct MedicionBenchmark {
+    double segundos;            // Tiempo de pared
+    long long fallos_cache;     // Fallos de caché (-1 si no se pudieron medir)
+};
+
+// Mide una función con tiempo de pared y contador de fallos de caché
+template <class Funcion>
+MedicionBenchmark medir(ContadorFallosCache& contador, Funcion funcion) {
+    auto inicio = chrono::steady_clock::now();
+    contador.iniciar();
+    funcion();
+    long long fallos = contador.detener();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    return MedicionBenchmark{segundos, fallos};
+}
+
+// Compara la página anterior (arreglo de estructuras de ~32 bytes) con la tabla de
+// PTE empaquetadas al recorrer todas las páginas y al liberarlas en bloque.
+void ejecutarBenchmarkPTE(size_t num_paginas) {
+    // Disposición anterior de Pagina, reproducida para la comparación
+    struct PaginaAoS {
+        int pid;
+        int id_pagina;
+        int id_global;
+        bool en_ram;
+        int indice_marco;
+        int indice_swap;
+        unsigned long long tiempo_carga;
+    };
+
+    const int paginas_por_proceso = 1000;
+    mt19937 generador(12345);
+    bernoulli_distribution en_ram(0.5);
+
+    cout << COLOR_INFO << "=== BENCHMARK PTE: " << num_paginas << " páginas ===" << COLOR_RESET << endl;
+    cout << COLOR_INFO << "Bytes por página: AoS " << sizeof(PaginaAoS)
+         << " | PTE empaquetada " << sizeof(uint64_t) << " (estado caliente)" << COLOR_RESET << endl;
+
+    vector<PaginaAoS> aos(num_paginas);
+    TablaPaginas tabla;
+    for (size_t i = 0; i < num_paginas; ++i) {
+        int dueno = i / paginas_por_proceso;
+        int local = i % paginas_por_proceso;
+        bool presente = en_ram(generador);
+        aos[i] = PaginaAoS{dueno + 1, local, static_cast<int>(i + 1), presente,
+                           presente ? static_cast<int>(i) : -1, presente ? -1 : static_cast<int>(i), i};
+        int indice = tabla.crear(dueno, local, i + 1);
+        if (presente) tabla.moverARam(indice, i);
+        else tabla.moverASwap(indice, i);
     }
 
-    // Encuentra un marco libre en un vector de marcos (RAM o SWAP)
-    int encontrarMarcoLibre(const vector<int>& marcos) {
-        for (size_t i = 0; i < marcos.size(); ++i) {
-            if (marcos[i] == -1) return i; // Retorna el índice del primer marco libre
+    ContadorFallosCache contador;
+    unsigned long long suma_aos = 0, suma_pte = 0;
+
+    // Recorrido: contar páginas en RAM y sumar sus marcos (lo que lee una búsqueda de víctima)
+    MedicionBenchmark recorrido_aos = medir(contador, [&]() {
+        for (const auto& pagina : aos) {
+            if (pagina.en_ram && pagina.pid != -1) suma_aos += pagina.indice_marco;
+        }
+    });
+    MedicionBenchmark recorrido_pte = medir(contador, [&]() {
+        for (size_t i = 0; i < num_paginas; ++i) {
+            if (tabla.enRam(i)) suma_pte += tabla.ubicacion(i);
+        }
+    });
+
+    // Liberación masiva: finalizar todos los procesos página por página
+    MedicionBenchmark liberacion_aos = medir(contador, [&]() {
+        for (auto& pagina : aos) {
+            pagina.pid = -1;
+            pagina.en_ram = false;
         }
-        return -1; // No hay marcos libres
-    }
+    });
+    MedicionBenchmark liberacion_pte = medir(contador, [&]() {
+        for (size_t i = 0; i < num_paginas; ++i) tabla.liberar(i);
+    });
 
-    // Política FIFO: selecciona la página más antigua en RAM para reemplazar
-    int elegirPaginaVictima() {
-        int victima = -1;
-        unsigned long long tiempo_mas_antiguo = numeric_limits<unsigned long long>::max();
-        
-        // Buscar entre todas las páginas en RAM
-        for (size_t i = 0; i < paginas.size(); ++i) {
-            if (paginas[i].en_ram && paginas[i].pid != -1 && paginas[i].tiempo_carga < tiempo_mas_antiguo) {
-                tiempo_mas_antiguo = paginas[i].tiempo_carga;
-                victima = i; // Actualizar víctima con la página más antigua
+    auto mostrar = [&](const string& operacion, const MedicionBenchmark& antes, const MedicionBenchmark& despues) {
+        cout << COLOR_INFO << operacion << ": AoS " << antes.segundos * 1e3 << " ms, PTE "
+             << despues.segundos * 1e3 << " ms";
+        if (antes.fallos_cache >= 0 && despues.fallos_cache >= 0) {
+            cout << " | fallos de caché AoS " << antes.fallos_cache << ", PTE " << despues.fallos_cache;
+            if (despues.fallos_cache > 0) {
+                cout << " (" << static_cast<double>(antes.fallos_cache) / despues.fallos_cache << "x menos)";
             }
         }
-        return victima; // Retorna -1 si no hay páginas en RAM
+        cout << COLOR_RESET << endl;
+    };
+    mostrar("Recorrido", recorrido_aos, recorrido_pte);
+    mostrar("Liberación", liberacion_aos, liberacion_pte);
+    if (!contador.disponible()) {
+        cout << COLOR_INFO << "Contador de fallos de caché no disponible (perf_event_open); solo tiempos"
+             << COLOR_RESET << endl;
     }
+    if (suma_aos != suma_pte) {
+        cout << COLOR_ERROR << "Error: los recorridos no coinciden" << COLOR_RESET << endl;
+    }
+}
 
-    // Crea un nuevo proceso con tamaño aleatorio
-    bool crearProceso() {
-        // Generar tamaño aleatorio del proceso dentro del rango especificado
-        uniform_int_distribution<int> distribucion_tamano(proceso_min_mb, proceso_max_mb);
-        int tamano_proceso = distribucion_tamano(generador_aleatorio);
-        int num_paginas = ceil(static_cast<double>(tamano_proceso) / tamano_pagina_mb);
-        
-        // Crear nuevo proceso
-        Proceso nuevo_proceso(siguiente_pid++, tamano_proceso, num_paginas);
-        
-        cout << COLOR_INFO << "[CREACIÓN] Proceso PID=" << nuevo_proceso.pid 
-             << " (" << tamano_proceso << " MB, " << num_paginas << " páginas)" << COLOR_RESET << endl;
+// Resultado acumulado de una prueba del conjunto de benchmarks
+struct ResultadoBenchmark {
+    string prueba;
+    size_t marcos = 0;                  // Marcos de RAM del simulador medido
+    unsigned long long operaciones = 0;
+    double segundos = 0.0;
+    long long fallos_cache = -1;        // -1 si no se pudieron medir
+    long rss_pico_kb = 0;               // RSS máximo del proceso al terminar la prueba
+
+    void agregar(const MedicionBenchmark& medicion, unsigned long long num_operaciones) {
+        operaciones += num_operaciones;
+        segundos += medicion.segundos;
+        if (medicion.fallos_cache >= 0) fallos_cache = max(0LL, fallos_cache) + medicion.fallos_cache;
+    }
+};
+
+// RSS máximo del proceso en KB (crece de forma monótona durante la ejecución)
+long rssPicoKB() {
+    rusage uso{};
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+// Escribe los resultados de los benchmarks en CSV o JSON (formato versionado)
+void escribirResultadosBenchmark(ostream& salida, bool json, const vector<ResultadoBenchmark>& resultados,
+                                 bool cabecera = true) {
+    if (json) salida << "{\"formato\": 1, \"resultados\": [\n";
+    else if (cabecera) salida << "formato,prueba,marcos,operaciones,ns_op,ops_s,fallos_cache_op,rss_pico_kb\n";
+    for (size_t i = 0; i < resultados.size(); ++i) {
+        const ResultadoBenchmark& r = resultados[i];
+        double ns_op = r.operaciones ? r.segundos * 1e9 / r.operaciones : 0.0;
+        double ops_s = r.segundos > 0 ? r.operaciones / r.segundos : 0.0;
+        double fallos_op = (r.fallos_cache >= 0 && r.operaciones) ? double(r.fallos_cache) / r.operaciones : -1.0;
+        if (json) {
+            salida << "  {\"prueba\": \"" << r.prueba << "\", \"marcos\": " << r.marcos
+                   << ", \"operaciones\": " << r.operaciones << ", \"ns_op\": " << ns_op
+                   << ", \"ops_s\": " << ops_s << ", \"fallos_cache_op\": " << fallos_op
+                   << ", \"rss_pico_kb\": " << r.rss_pico_kb << (i + 1 < resultados.size() ? "},\n" : "}\n");
+        } else {
+            salida << 1 << ',' << r.prueba << ',' << r.marcos << ',' << r.operaciones << ',' << ns_op << ','
+                   << ops_s << ',' << fallos_op << ',' << r.rss_pico_kb << '\n';
+        }
+    }
+    if (json) salida << "]}\n";
+}
+
+// Mide los caminos principales del simulador (FIFO, semilla fija, sin salida) con
+// memorias de 1K marcos hasta max_marcos (x10 por paso). Con pocos marcos se repite
+// la medición en varias rondas para reunir ~1M de operaciones por prueba.
+void ejecutarBenchmarks(size_t max_marcos, const string& archivo) {
+    const int PAGINAS_PROCESO = 16;
+    using Simulador = SimuladorMemoria<PoliticaFIFO>;
+    ContadorFallosCache contador;
+    vector<ResultadoBenchmark> resultados;
+    
+    cout << COLOR_INFO << "=== BENCHMARKS: 1K a " << max_marcos << " marcos, FIFO, páginas de 1 MB, "
+         << PAGINAS_PROCESO << " páginas por proceso ===" << COLOR_RESET << endl;
+    if (!contador.disponible()) {
+        cout << COLOR_INFO << "Contador de fallos de caché no disponible (perf_event_open); solo tiempos"
+             << COLOR_RESET << endl;
+    }
+    cout << "formato,prueba,marcos,operaciones,ns_op,ops_s,fallos_cache_op,rss_pico_kb" << endl;
+    
+    for (size_t marcos = 1000; marcos <= max_marcos; marcos *= 10) {
+        ConfiguracionSimulacion config;
+        config.memoria_fisica = uint64_t(marcos) << 20;
+        config.tamano_pagina = 1 << 20;
+        config.proceso_min = uint64_t(PAGINAS_PROCESO) << 20;
+        config.proceso_max = uint64_t(PAGINAS_PROCESO) << 20;
+        config.semilla = 42;
+        config.factor_virtual = 3.0;            // SWAP = 2 × RAM
+        config.modelo_carga = ModeloCarga::UNIFORME;
+        config.nivel_registro = "silencio";
         
-        // Verificar si hay suficiente memoria total (RAM + SWAP)
-        int ram_libre = count(marcos_ram.begin(), marcos_ram.end(), -1);
-        int swap_libre = count(marcos_swap.begin(), marcos_swap.end(), -1);
+        size_t procesos_ram = marcos / PAGINAS_PROCESO;        // Llenan la RAM
+        size_t procesos_swap = marcos / 2 / PAGINAS_PROCESO;   // Quedan completos en SWAP
+        size_t rondas = max<size_t>(1, 1000000 / marcos);
         
-        if (ram_libre + swap_libre < num_paginas) {
-            cout << COLOR_ERROR << "[ERROR] Memoria insuficiente para proceso PID=" 
-                 << nuevo_proceso.pid << COLOR_RESET << endl;
-            return false;
-        }
+        ResultadoBenchmark crear{"crearProceso", marcos};
+        ResultadoBenchmark acierto{"acceso_acierto", marcos};
+        ResultadoBenchmark victima{"elegirPaginaVictima", marcos};
+        ResultadoBenchmark expulsion{"acceso_fallo_expulsion", marcos};
+        ResultadoBenchmark fallo{"acceso_fallo", marcos};
+        ResultadoBenchmark finalizar{"finalizarProcesoAleatorio", marcos};
+        ResultadoBenchmark estado{"mostrarEstado", marcos};
+        ResultadoBenchmark eventos{"simulacion_eventos", marcos};
+        long long suma = 0; // Evita que el compilador descarte las llamadas medidas
         
-        // Asignar páginas del proceso
-        for (int i = 0; i < num_paginas; ++i) {
-            Pagina nueva_pagina(nuevo_proceso.pid, i, siguiente_id_pagina++);
-            int indice_pagina = paginas.size();
-            
-            // Intentar cargar en RAM primero (política de asignación)
-            int marco_libre = encontrarMarcoLibre(marcos_ram);
-            if (marco_libre != -1) {
-                // Hay espacio en RAM
-                nueva_pagina.en_ram = true;
-                nueva_pagina.indice_marco = marco_libre;
-                nueva_pagina.tiempo_carga = contador_carga++; // Marcar tiempo de carga para FIFO
-                
-                marcos_ram[marco_libre] = indice_pagina; // Asignar marco en RAM
-                cout << COLOR_RAM << "  → Página " << nueva_pagina.id_global 
-                     << " (PID=" << nuevo_proceso.pid << "-" << i 
-                     << ") cargada en RAM (marco " << marco_libre << ")" << COLOR_RESET << endl;
-            } else {
-                // RAM llena, usar SWAP
-                marco_libre = encontrarMarcoLibre(marcos_swap);
-                if (marco_libre == -1) {
-                    cout << COLOR_ERROR << "  → ERROR: No hay marcos libres en SWAP" << COLOR_RESET << endl;
-                    return false;
-                }
-                nueva_pagina.en_ram = false;
-                nueva_pagina.indice_swap = marco_libre;
-                
-                marcos_swap[marco_libre] = indice_pagina; // Asignar marco en SWAP
-                cout << COLOR_SWAP << "  → Página " << nueva_pagina.id_global 
-                     << " (PID=" << nuevo_proceso.pid << "-" << i 
-                     << ") asignada a SWAP (marco " << marco_libre << ")" << COLOR_RESET << endl;
+        for (size_t ronda = 0; ronda < rondas; ++ronda) {
+            // RAM llena, luego procesos en SWAP: aciertos, víctimas, fallos con expulsión y finalización
+            auto simulador = make_unique<Simulador>(config);
+            crear.agregar(medir(contador, [&]() {
+                for (size_t p = 0; p < procesos_ram; ++p) simulador->crearProceso();
+            }), procesos_ram);
+            acierto.agregar(medir(contador, [&]() {
+                for (size_t i = 0; i < marcos; ++i) simulador->simularAccesoMemoria();
+            }), marcos);
+            victima.agregar(medir(contador, [&]() {
+                for (size_t i = 0; i < marcos; ++i) suma += simulador->elegirPaginaVictima();
+            }), marcos);
+            vector<int> en_swap;
+            for (size_t p = 0; p < procesos_swap; ++p) {
+                en_swap.push_back(simulador->crearProcesoConPaginas(uint64_t(PAGINAS_PROCESO) << 20, PAGINAS_PROCESO));
             }
+            expulsion.agregar(medir(contador, [&]() {
+                for (int indice : en_swap) {
+                    for (int pagina = 0; pagina < PAGINAS_PROCESO; ++pagina) {
+                        simulador->accederPagina(simulador->obtenerProceso(indice), pagina, false);
+                    }
+                }
+            }), en_swap.size() * PAGINAS_PROCESO);
+            size_t activos = simulador->numProcesosActivos();
+            finalizar.agregar(medir(contador, [&]() {
+                while (simulador->numProcesosActivos() > 0) simulador->finalizarProcesoAleatorio();
+            }), activos);
+            simulador.reset();
             
-            // Agregar página a la lista global y al proceso
-            paginas.push_back(nueva_pagina);
-            nuevo_proceso.indices_paginas.push_back(indice_pagina);
-        }
-        
-        // Agregar proceso a la lista
-        procesos.push_back(nuevo_proceso);
-        procesos_creados++;
-        return true;
-    }
-
-    // Finaliza un proceso aleatorio y libera su memoria
-    void finalizarProcesoAleatorio() {
-        // Obtener índices de procesos activos
-        vector<int> indices_activos;
-        for (size_t i = 0; i < procesos.size(); ++i) {
-            if (procesos[i].activo) {
-                indices_activos.push_back(i);
+            // Fallos sin expulsión: se finalizan los procesos de RAM y se traen los de SWAP
+            simulador = make_unique<Simulador>(config);
+            vector<int> en_ram;
+            for (size_t p = 0; p < procesos_ram; ++p) {
+                en_ram.push_back(simulador->crearProcesoConPaginas(uint64_t(PAGINAS_PROCESO) << 20, PAGINAS_PROCESO));
             }
+            en_swap.clear();
+            for (size_t p = 0; p < procesos_swap; ++p) {
+                en_swap.push_back(simulador->crearProcesoConPaginas(uint64_t(PAGINAS_PROCESO) << 20, PAGINAS_PROCESO));
+            }
+            for (int indice : en_ram) simulador->finalizarProceso(indice);
+            fallo.agregar(medir(contador, [&]() {
+                for (int indice : en_swap) {
+                    for (int pagina = 0; pagina < PAGINAS_PROCESO; ++pagina) {
+                        simulador->accederPagina(simulador->obtenerProceso(indice), pagina, false);
+                    }
+                }
+            }), en_swap.size() * PAGINAS_PROCESO);
         }
         
-        if (indices_activos.empty()) {
-            cout << COLOR_INFO << "[FINALIZACIÓN] No hay procesos activos" << COLOR_RESET << endl;
-            return;
+        // mostrarEstado con el registro de eventos habilitado (formatea la línea completa)
+        {
+            ConfiguracionSimulacion config_estado = config;
+            config_estado.nivel_registro = "eventos";
+            config_estado.archivo_registro = "/dev/null";
+            Simulador simulador(config_estado);
+            const size_t llamadas = 1000000;
+            estado.agregar(medir(contador, [&]() {
+                for (size_t i = 0; i < llamadas; ++i) simulador.mostrarEstado();
+            }), llamadas);
         }
         
-        // Seleccionar proceso aleatorio para finalizar
-        uniform_int_distribution<int> distribucion(0, indices_activos.size() - 1);
-        int indice_proceso = indices_activos[distribucion(generador_aleatorio)];
-        Proceso& proceso = procesos[indice_proceso];
-        
-        cout << COLOR_INFO << "[FINALIZACIÓN] Terminando proceso PID=" 
-             << proceso.pid << COLOR_RESET << endl;
-        
-        // Liberar todas las páginas del proceso
-        for (int indice_pagina : proceso.indices_paginas) {
-            Pagina& pagina = paginas[indice_pagina];
-            if (pagina.en_ram) {
-                marcos_ram[pagina.indice_marco] = -1; // Liberar marco en RAM
-                cout << COLOR_RAM << "  → Liberada página " << pagina.id_global 
-                     << " (PID=" << pagina.pid << "-" << pagina.id_pagina 
-                     << ") de RAM (marco " << pagina.indice_marco << ")" << COLOR_RESET << endl;
-            } else {
-                marcos_swap[pagina.indice_swap] = -1; // Liberar marco en SWAP
-                cout << COLOR_SWAP << "  → Liberada página " << pagina.id_global 
-                     << " (PID=" << pagina.pid << "-" << pagina.id_pagina 
-                     << ") de SWAP (marco " << pagina.indice_swap << ")" << COLOR_RESET << endl;
-            }
-            // Marcar página como liberada (pid = -1)
-            pagina.pid = -1;
+        // Motor de eventos completo: ~1M eventos, procesos que ocupan la mitad de la RAM
+        {
+            ConfiguracionSimulacion config_eventos = config;
+            config_eventos.tasa_llegadas = 100;
+            config_eventos.tasa_finalizaciones = 0;
+            config_eventos.tasa_accesos = 100000;
+            config_eventos.inicio_periodicos = 1;
+            config_eventos.duracion = 10;
+            config_eventos.max_procesos = max<size_t>(1, marcos / 2 / PAGINAS_PROCESO);
+            Simulador simulador(config_eventos);
+            MedicionBenchmark medicion = medir(contador, [&]() { simulador.ejecutarSimulacion(); });
+            eventos.agregar(medicion, simulador.obtenerResultado().eventos_procesados);
         }
         
-        // Marcar proceso como inactivo y limpiar sus páginas
-        proceso.activo = false;
-        proceso.indices_paginas.clear();
-        procesos_finalizados++;
+        vector<ResultadoBenchmark> tamano{crear, acierto, victima, expulsion, fallo, finalizar, estado, eventos};
+        for (ResultadoBenchmark& r : tamano) r.rss_pico_kb = rssPicoKB();
+        escribirResultadosBenchmark(cout, false, tamano, false);
+        resultados.insert(resultados.end(), tamano.begin(), tamano.end());
+        volatile long long sumidero = suma;
+        (void)sumidero;
     }
-
-    // Simulamos un acceso a memoria (puede causar fallo de página)
-    bool simularAccesoMemoria() {
-        // Obtener índices de procesos activos
-        vector<int> indices_activos;
-        for (size_t i = 0; i < procesos.size(); ++i) {
-            if (procesos[i].activo) {
-                indices_activos.push_back(i);
-            }
+    
+    if (!archivo.empty()) {
+        bool json = archivo.size() >= 5 && archivo.compare(archivo.size() - 5, 5, ".json") == 0;
+        ofstream salida(archivo);
+        if (!salida) {
+            cout << COLOR_ERROR << "Error: No se pudo crear " << archivo << COLOR_RESET << endl;
+            return;
         }
+        escribirResultadosBenchmark(salida, json, resultados);
+        cout << COLOR_INFO << "Resultados escritos en " << archivo << COLOR_RESET << endl;
+    }
+}
+
+// Lee las opciones "--opcion valor" de la línea de comandos. Retorna false ante un error.
+bool leerOpciones(int argc, char* argv[], ConfiguracionSimulacion& config) {
+    for (int i = 1; i < argc; ++i) {
+        string opcion = argv[i];
         
-        if (indices_activos.empty()) {
-            cout << COLOR_INFO << "[ACCESO] No hay procesos activos" << COLOR_RESET << endl;
-            return true;
+        // Opciones sin valor
+        if (opcion == "--poisson") {
+            config.intervalos_poisson = true;
+            continue;
         }
-        
-        // Buscamos específicamente páginas en SWAP para forzar fallos de página
-        int indice_elegido = -1;
-        int pagina_acceder = -1;
-        bool encontrado_en_swap = false;
-        
-        // Primero buscar procesos con páginas en SWAP
-        for (int idx : indices_activos) {
-            Proceso& p = procesos[idx];
-            for (int i = 0; i < p.num_paginas; ++i) {
-                int indice_pag = p.indices_paginas[i];
-                if (!paginas[indice_pag].en_ram) {
-                    indice_elegido = idx;
-                    pagina_acceder = i;
-                    encontrado_en_swap = true;
-                    break;
-                }
-            }
-            if (encontrado_en_swap) break;
+        if (opcion == "--concurrente") {
+            config.modo_concurrente = true;
+            continue;
         }
         
-        // Si no hay páginas en swap, elegir proceso y página aleatoria
-        if (!encontrado_en_swap) {
-            uniform_int_distribution<int> dist_proceso(0, indices_activos.size() - 1);
-            indice_elegido = indices_activos[dist_proceso(generador_aleatorio)];
-            Proceso& p = procesos[indice_elegido];
-            uniform_int_distribution<int> dist_pagina(0, p.num_paginas - 1);
-            pagina_acceder = dist_pagina(generador_aleatorio);
+        // El resto de las opciones requieren un valor
+        if (i + 1 >= argc) {
+            cout << COLOR_ERROR << "Error: Falta el valor de la opción " << opcion << COLOR_RESET << endl;
+            return false;
         }
+        const char* valor = argv[++i];
+        bool valido = true;  // Los números y si|no se leen completos, sin texto sobrante
         
-        // Obtener la página específica
-        Proceso& proceso = procesos[indice_elegido];
-        int indice_pagina = proceso.indices_paginas[pagina_acceder];
-        Pagina& pagina = paginas[indice_pagina];
-        
-        cout << COLOR_INFO << "[ACCESO] PID=" << proceso.pid 
-             << " → Página: " << pagina.id_global << " (local:" << pagina.id_pagina << ")"
-             << " → En RAM: " << (pagina.en_ram ? "Sí" : "No") << COLOR_RESET << endl;
-        
-        // Si la página ya está en RAM, acceso normal
-        if (pagina.en_ram) {
-            cout << COLOR_RAM << "  → Página " << pagina.id_global 
-                 << " YA en RAM (marco " << pagina.indice_marco << ")" << COLOR_RESET << endl;
-            return true;
+        if (opcion == "--memoria" || opcion == "--pagina" || opcion == "--proceso-min" || opcion == "--proceso-max") {
+            uint64_t& tamano = opcion == "--memoria" ? config.memoria_fisica : opcion == "--pagina" ? config.tamano_pagina :
+                               opcion == "--proceso-min" ? config.proceso_min : config.proceso_max;
+            if (!leerTamano(valor, tamano)) {
+                cout << COLOR_ERROR << "Error: Tamaño inválido " << valor << " para " << opcion
+                     << " (número en MB o con sufijo B, K, M, G o T)" << COLOR_RESET << endl;
+                return false;
+            }
         }
-        
-        // Esto es para los fallos de página
-        cout << COLOR_FALLO << "  → FALLO DE PÁGINA! Página " << pagina.id_global 
-             << " no está en RAM" << COLOR_RESET << endl;
-        fallos_pagina++; // Incrementar contador de fallos de página
-        
-        // Buscar marco libre en RAM
-        int marco_libre = encontrarMarcoLibre(marcos_ram);
-        
-        if (marco_libre == -1) {
-            // RAM llena, necesitamos reemplazar una página usando FIFO
-            cout << COLOR_FALLO << "  → RAM llena, buscando víctima para reemplazar..." << COLOR_RESET << endl;
-            int indice_victima = elegirPaginaVictima();
-            
-            if (indice_victima == -1) {
-                cout << COLOR_ERROR << "  → ERROR: No se encontró víctima para reemplazar" << COLOR_RESET << endl;
+        else if (opcion == "--semilla") valido = leerEntero(valor, config.semilla);
+        else if (opcion == "--duracion") valido = leerReal(valor, config.duracion);
+        else if (opcion == "--tasa-llegadas") valido = leerReal(valor, config.tasa_llegadas);
+        else if (opcion == "--tasa-finalizaciones") valido = leerReal(valor, config.tasa_finalizaciones);
+        else if (opcion == "--tasa-accesos") valido = leerReal(valor, config.tasa_accesos);
+        else if (opcion == "--inicio-periodicos") valido = leerReal(valor, config.inicio_periodicos);
+        else if (opcion == "--max-procesos") valido = leerEntero(valor, config.max_procesos);
+        else if (opcion == "--politica") config.politica = valor;
+        else if (opcion == "--traza") config.archivo_traza = valor;
+        else if (opcion == "--carga") {
+            if (!leerModeloCarga(valor, config.modelo_carga)) {
+                cout << COLOR_ERROR << "Error: Modelo de carga desconocido " << valor
+                     << " (use forzado, uniforme, zipf, conjunto, secuencial o mixta)" << COLOR_RESET << endl;
                 return false;
             }
-            
-            Pagina& victima = paginas[indice_victima];
-            cout << COLOR_SWAP << "  → Víctima seleccionada: Página " << victima.id_global 
-                 << " (PID=" << victima.pid << "-" << victima.id_pagina 
-                 << ") (marco " << victima.indice_marco << ")" << COLOR_RESET << endl;
-            
-            // Mover víctima a SWAP
-            int marco_swap_libre = encontrarMarcoLibre(marcos_swap);
-            if (marco_swap_libre == -1) {
-                cout << COLOR_ERROR << "  → ERROR: No hay espacio en SWAP" << COLOR_RESET << endl;
+        }
+        else if (opcion == "--zipf-exponente") valido = leerReal(valor, config.zipf_exponente);
+        else if (opcion == "--ventana") valido = leerReal(valor, config.fraccion_ventana);
+        else if (opcion == "--deriva") valido = leerEntero(valor, config.accesos_por_deriva);
+        else if (opcion == "--fase") valido = leerEntero(valor, config.accesos_por_fase);
+        else if (opcion == "--registro") {
+            NivelRegistro nivel;
+            if (!leerNivelRegistro(valor, nivel)) {
+                cout << COLOR_ERROR << "Error: Nivel de registro desconocido " << valor
+                     << " (use silencio, resumen, eventos o detalle)" << COLOR_RESET << endl;
                 return false;
             }
-            
-            // Realizar swap-out de la víctima
-            marcos_swap[marco_swap_libre] = indice_victima;
-            marcos_ram[victima.indice_marco] = -1; // Liberar marco en RAM
-            
-            victima.en_ram = false;
-            victima.indice_swap = marco_swap_libre;
-            cout << COLOR_SWAP << "  → Víctima movida a SWAP (marco " << marco_swap_libre << ")" << COLOR_RESET << endl;
-            
-            marco_libre = victima.indice_marco; // Usar el marco liberado
-            victima.indice_marco = -1;
+            config.nivel_registro = valor;
         }
-        
-        // Mover la página solicitada a RAM (swap-in)
-        if (pagina.indice_swap != -1) {
-            marcos_swap[pagina.indice_swap] = -1;  // Liberar espacio en SWAP
-            cout << COLOR_SWAP << "  → Página " << pagina.id_global 
-                 << " liberada de SWAP (marco " << pagina.indice_swap << ")" << COLOR_RESET << endl;
+        else if (opcion == "--registro-binario") config.archivo_registro_binario = valor;
+        else if (opcion == "--registro-archivo") config.archivo_registro = valor;
+        else if (opcion == "--metricas") config.prefijo_metricas = valor;
+        else if (opcion == "--intervalo-metricas") valido = leerReal(valor, config.intervalo_metricas);
+        else if (opcion == "--swap-archivo") config.archivo_swap = valor;
+        else if (opcion == "--lote-swap") valido = leerEntero(valor, config.lote_swap);
+        else if (opcion == "--hilos-es") valido = leerEntero(valor, config.hilos_es);
+        else if (opcion == "--swap-directo") valido = leerSiNo(valor, config.swap_directo);
+        else if (opcion == "--zswap") valido = leerEntero(valor, config.cache_comprimida_mb);
+        else if (opcion == "--zswap-umbral") valido = leerReal(valor, config.umbral_compresion);
+        else if (opcion == "--anticipacion") valido = leerEntero(valor, config.paginas_anticipacion);
+        else if (opcion == "--anticipacion-modo") config.modo_anticipacion = valor;
+        else if (opcion == "--marca-min") valido = leerReal(valor, config.marca_min);
+        else if (opcion == "--marca-baja") valido = leerReal(valor, config.marca_baja);
+        else if (opcion == "--marca-alta") valido = leerReal(valor, config.marca_alta);
+        else if (opcion == "--lote-recuperacion") valido = leerEntero(valor, config.lote_recuperacion);
+        else if (opcion == "--intervalo-recuperacion") valido = leerReal(valor, config.intervalo_recuperacion);
+        else if (opcion == "--fork") valido = leerReal(valor, config.probabilidad_fork);
+        else if (opcion == "--biblioteca") valido = leerEntero(valor, config.paginas_biblioteca);
+        else if (opcion == "--escrituras") valido = leerReal(valor, config.fraccion_escrituras);
+        else if (opcion == "--ksm") valido = leerEntero(valor, config.paginas_ksm);
+        else if (opcion == "--ksm-intervalo") valido = leerReal(valor, config.intervalo_ksm);
+        else if (opcion == "--demanda") valido = leerSiNo(valor, config.paginacion_demanda);
+        else if (opcion == "--paginas-enormes") valido = leerSiNo(valor, config.paginas_enormes);
+        else if (opcion == "--enormes-escaneo") valido = leerEntero(valor, config.regiones_promocion);
+        else if (opcion == "--enormes-intervalo") valido = leerReal(valor, config.intervalo_promocion);
+        else if (opcion == "--conjunto-trabajo") valido = leerEntero(valor, config.ventana_trabajo);
+        else if (opcion == "--control-carga") valido = leerSiNo(valor, config.control_carga);
+        else if (opcion == "--control-intervalo") valido = leerReal(valor, config.intervalo_control);
+        else if (opcion == "--costo-swap") valido = leerReal(valor, config.costo_swap_us);
+        else if (opcion == "--factor-virtual") valido = leerReal(valor, config.factor_virtual);
+        else if (opcion == "--barrido") config.archivo_barrido = valor;
+        else if (opcion == "--hilos") valido = leerEntero(valor, config.hilos);
+        else if (opcion == "--salida") config.archivo_resultados = valor;
+        else if (opcion == "--guardar-estado") config.archivo_guardar_estado = valor;
+        else if (opcion == "--restaurar-estado") config.archivo_restaurar_estado = valor;
+        else if (opcion == "--accesos") valido = leerEntero(valor, config.accesos_por_proceso);
+        else if (opcion == "--tlb") valido = leerEntero(valor, config.tlb_entradas);
+        else if (opcion == "--tlb-vias") valido = leerEntero(valor, config.tlb_vias);
+        else if (opcion == "--tlb-asid") valido = leerSiNo(valor, config.tlb_asid);
+        else if (opcion == "--tlb-reemplazo") config.tlb_reemplazo = valor;
+        else {
+            cout << COLOR_ERROR << "Error: Opción desconocida " << opcion << COLOR_RESET << endl;
+            return false;
+        }
+        if (!valido) {
+            cout << COLOR_ERROR << "Error: Valor inválido " << valor << " para " << opcion << COLOR_RESET << endl;
+            return false;
         }
-        
-        // Actualizar estado de la página
-        pagina.en_ram = true;
-        pagina.indice_marco = marco_libre;
-        pagina.indice_swap = -1;
-        pagina.tiempo_carga = contador_carga++; // Actualizar tiempo de carga para FIFO
-        
-        marcos_ram[marco_libre] = indice_pagina; // Asignar marco en RAM
-        
-        cout << COLOR_RAM << "  → Página " << pagina.id_global 
-             << " movida a RAM (marco " << marco_libre << ")" << COLOR_RESET << endl;
-        return true;
     }
+    return true;
+}
 
-    // Muestra el estado actual del sistema
-    void mostrarEstado() {
-        // Calcular uso de RAM
-        int ram_usada = marcos_ram.size() - count(marcos_ram.begin(), marcos_ram.end(), -1);
-        // Calcular uso de SWAP
-        int swap_usada = marcos_swap.size() - count(marcos_swap.begin(), marcos_swap.end(), -1);
-        // Contar procesos activos
-        int procesos_activos = 0;
-        for (const auto& p : procesos) {
-            if (p.activo) procesos_activos++;
+// Verifica que la configuración se pueda simular. Retorna false y el motivo si no.
+bool validarConfiguracion(const ConfiguracionSimulacion& config, string& error) {
+    if (config.memoria_fisica == 0 || config.tamano_pagina == 0 ||
+        config.proceso_min == 0 || config.proceso_max == 0) {
+        error = "Todos los valores deben ser positivos";
+        return false;
+    }
+    if (config.proceso_min > config.proceso_max) {
+        error = "El tamaño mínimo no puede ser mayor al máximo";
+        return false;
+    }
+    if (config.tamano_pagina % 4096 != 0) {
+        error = "El tamaño de página debe ser múltiplo de 4 KB";
+        return false;
+    }
+    if (config.memoria_fisica / config.tamano_pagina > (1ULL << 28)) {
+        error = "La memoria física no puede tener más de 2^28 marcos";
+        return false;
+    }
+    if (config.proceso_max > BYTES_ESPACIO_VIRTUAL) {
+        error = "Un proceso no puede superar el espacio virtual de 48 bits (256 TB)";
+        return false;
+    }
+    if (config.regiones_promocion <= 0 || config.intervalo_promocion <= 0) {
+        error = "El promotor de páginas enormes necesita regiones y un intervalo positivos";
+        return false;
+    }
+    if (config.ventana_trabajo < 0 || config.intervalo_control <= 0 || config.costo_swap_us < 0) {
+        error = "El control de carga necesita una ventana >= 0, un intervalo positivo y un costo de SWAP >= 0";
+        return false;
+    }
+    if (config.ventana_trabajo > 0 && !config.archivo_traza.empty()) {
+        error = "El control de carga no se aplica a trazas (la traza decide cuándo corre cada proceso)";
+        return false;
+    }
+    if ((!config.archivo_guardar_estado.empty() || !config.archivo_restaurar_estado.empty()) &&
+        (!config.archivo_traza.empty() || !config.archivo_swap.empty() || config.modo_concurrente)) {
+        error = "Guardar o restaurar el estado no se aplica a trazas, al modo contenido ni al modo concurrente";
+        return false;
+    }
+    if (config.duracion <= 0) {
+        error = "La duración debe ser positiva";
+        return false;
+    }
+    if (config.tasa_llegadas < 0 || config.tasa_finalizaciones < 0 || config.tasa_accesos < 0 || config.max_procesos < 0) {
+        error = "Las tasas y el máximo de procesos no pueden ser negativos";
+        return false;
+    }
+    if (config.factor_virtual < 0) {
+        error = "El factor de memoria virtual no puede ser negativo";
+        return false;
+    }
+    // Las ranuras de SWAP son int: RAM + SWAP se acota con el factor más grande posible
+    double factor_maximo = config.factor_virtual > 0 ? config.factor_virtual : 4.5;
+    if (config.memoria_fisica * factor_maximo / config.tamano_pagina >= double(1ULL << 31)) {
+        error = "La memoria virtual (RAM + SWAP) debe tener menos de 2^31 marcos";
+        return false;
+    }
+    if (config.tlb_entradas < 0 || config.tlb_vias <= 0 ||
+        (config.tlb_entradas > 0 && config.tlb_entradas % config.tlb_vias != 0)) {
+        error = "Las entradas de la TLB deben ser un múltiplo positivo de sus vías";
+        return false;
+    }
+    if (config.lote_swap <= 0 || config.hilos_es <= 0) {
+        error = "El lote de SWAP y los hilos de E/S deben ser positivos";
+        return false;
+    }
+    if (config.paginas_anticipacion < 0 || config.paginas_anticipacion > 1024) {
+        error = "La lectura anticipada debe estar entre 0 y 1024 páginas";
+        return false;
+    }
+    if (config.modo_anticipacion != "virtual" && config.modo_anticipacion != "swap") {
+        error = "Modo de lectura anticipada desconocido " + config.modo_anticipacion + " (use virtual o swap)";
+        return false;
+    }
+    if (config.marca_min < 0 || config.marca_min > config.marca_baja || config.marca_baja > config.marca_alta ||
+        config.marca_alta >= 100) {
+        error = "Las marcas de marcos libres deben cumplir 0 <= mínima <= baja <= alta < 100 (%)";
+        return false;
+    }
+    if (config.lote_recuperacion <= 0 || config.intervalo_recuperacion <= 0) {
+        error = "El lote y el intervalo de recuperación deben ser positivos";
+        return false;
+    }
+    if (config.cache_comprimida_mb < 0 || config.umbral_compresion <= 0 || config.umbral_compresion > 1) {
+        error = "La caché comprimida necesita un presupuesto >= 0 MB y un umbral entre 0 y 1";
+        return false;
+    }
+    if (config.cache_comprimida_mb > 0 && config.archivo_swap.empty()) {
+        error = "La caché comprimida necesita el modo contenido (--swap-archivo)";
+        return false;
+    }
+    if (config.probabilidad_fork < 0 || config.probabilidad_fork > 1 ||
+        config.fraccion_escrituras < 0 || config.fraccion_escrituras > 1) {
+        error = "La probabilidad de fork y la fracción de escrituras deben estar entre 0 y 1";
+        return false;
+    }
+    if (config.paginas_biblioteca < 0 || config.paginas_ksm < 0 || config.intervalo_ksm <= 0) {
+        error = "La biblioteca y el escáner de fusión necesitan páginas >= 0 y un intervalo positivo";
+        return false;
+    }
+    if (config.paginas_ksm > 0 && config.archivo_swap.empty()) {
+        error = "La fusión de páginas iguales necesita el modo contenido (--swap-archivo)";
+        return false;
+    }
+    if (config.intervalo_metricas <= 0) {
+        error = "El intervalo de métricas debe ser positivo";
+        return false;
+    }
+    if (config.tlb_reemplazo != "lru" && config.tlb_reemplazo != "fifo") {
+        error = "Reemplazo de TLB desconocido " + config.tlb_reemplazo + " (use lru o fifo)";
+        return false;
+    }
+    if (!config.archivo_registro.empty()) {
+        // Se abre sin truncar: el registro lo trunca al empezar la simulación
+        FILE* prueba = fopen(config.archivo_registro.c_str(), "a");
+        if (prueba == nullptr) {
+            error = "No se pudo crear el registro " + config.archivo_registro;
+            return false;
         }
-        
-        // Contar páginas actualmente en SWAP
-        int paginas_en_swap = 0;
-        for (const auto& pagina : paginas) {
-            if (!pagina.en_ram && pagina.pid != -1) {
-                paginas_en_swap++;
-            }
+        fclose(prueba);
+    }
+    return true;
+}
+
+// Crea y ejecuta un simulador con la política de reemplazo indicada. Si se entrega
+// resultado, la ejecución es parte de un barrido: se guarda ahí y no se escribe nada.
+template <class Politica>
+bool ejecutarConPolitica(const ConfiguracionSimulacion& config, ResultadoSimulacion* resultado = nullptr) {
+    if (config.archivo_traza.empty()) {
+        if (is_same<Politica, PoliticaOPT>::value && resultado == nullptr) {
+            cout << COLOR_INFO << "Aviso: OPT necesita conocer los accesos futuros; sin --traza "
+                 << "todas las páginas se consideran sin uso futuro" << COLOR_RESET << endl;
         }
-        
-        // Mostrar estado completo
-        cout << COLOR_INFO << "[ESTADO] RAM: " << ram_usada << "/" << marcos_ram.size()
-             << " | SWAP: " << swap_usada << "/" << marcos_swap.size()
-             << " | Procesos: " << procesos_activos
-             << " | Páginas en SWAP: " << paginas_en_swap
-             << " | Fallos de Página: " << fallos_pagina 
-             << " | Total páginas: " << paginas.size() << COLOR_RESET << endl;
+        SimuladorMemoria<Politica> simulador(config);
+        string error;
+        if (!config.archivo_restaurar_estado.empty() && !simulador.restaurarEstado(config.archivo_restaurar_estado, error)) {
+            if (resultado == nullptr) cout << COLOR_ERROR << "Error: " << error << COLOR_RESET << endl;
+            return false;
+        }
+        simulador.ejecutarSimulacion();
+        if (resultado) *resultado = simulador.obtenerResultado();
+        return true;
     }
+    
+    // Reproducción de traza
+    LectorTraza traza;
+    if (!traza.abrir(config.archivo_traza)) {
+        if (resultado == nullptr) cout << COLOR_ERROR << "Error: " << traza.obtenerError() << COLOR_RESET << endl;
+        return false;
+    }
+    SimuladorMemoria<Politica> simulador(config);
+    if constexpr (is_same<Politica, PoliticaOPT>::value) {
+        simulador.obtenerPolitica().cargarFuturo(simulador.clavesFuturas(traza));
+    }
+    simulador.reproducirTraza(traza);
+    if (resultado) *resultado = simulador.obtenerResultado();
+    return true;
+}
 
-    // Función principal que ejecuta la simulación
-    void ejecutarSimulacion() {
-        auto tiempo_inicio = chrono::steady_clock::now();
-        auto ultima_creacion = tiempo_inicio;
-        auto ultimo_periodico = tiempo_inicio;
-        
-        cout << COLOR_INFO << "=== INICIANDO SIMULACIÓN ===" << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Nota: Los eventos periódicos (accesos y finalizaciones) comenzarán después de 30 segundos" << COLOR_RESET << endl;
+// Indica si existe una política con ese nombre
+bool politicaConocida(const string& nombre) {
+    return nombre == "fifo" || nombre == "lru" || nombre == "clock" ||
+           nombre == "2q" || nombre == "arc" || nombre == "opt";
+}
+
+// Elige la instancia del simulador según el nombre de la política
+bool ejecutarSimulacion(const ConfiguracionSimulacion& config, ResultadoSimulacion* resultado = nullptr) {
+    if (config.politica == "fifo") return ejecutarConPolitica<PoliticaFIFO>(config, resultado);
+    if (config.politica == "lru") return ejecutarConPolitica<PoliticaLRU>(config, resultado);
+    if (config.politica == "clock") return ejecutarConPolitica<PoliticaClock>(config, resultado);
+    if (config.politica == "2q") return ejecutarConPolitica<Politica2Q>(config, resultado);
+    if (config.politica == "arc") return ejecutarConPolitica<PoliticaARC>(config, resultado);
+    if (config.politica == "opt") return ejecutarConPolitica<PoliticaOPT>(config, resultado);
+    if (resultado != nullptr) return false;
+    cout << COLOR_ERROR << "Error: Política desconocida " << config.politica
+         << " (use fifo, lru, clock, 2q, arc u opt)" << COLOR_RESET << endl;
+    return false;
+}
+
+// Al reproducir una traza, el tamaño de cada proceso lo define la traza
+void completarConfiguracionTraza(ConfiguracionSimulacion& config) {
+    if (!config.archivo_traza.empty()) {
+        if (config.proceso_min == 0) config.proceso_min = 1 << 20;
+        if (config.proceso_max == 0) config.proceso_max = config.proceso_min;
+    }
+}
+
+// ============================================================================
+// BARRIDO DE PARÁMETROS
+// ============================================================================
+
+// Un parámetro del barrido: la opción (sin "--") y los valores que toma
+struct ParametroBarrido {
+    string clave;
+    vector<string> valores;
+};
+
+// Lee la especificación de un barrido. Cada línea es "clave = valor1, valor2, ..."
+// donde la clave es cualquier opción de la línea de comandos sin "--" (memoria,
+// pagina, proceso-min, politica, carga, ...) o "repeticiones" (ejecuciones por
+// combinación, cada una con otra semilla). "#" inicia un comentario.
+bool leerEspecificacionBarrido(const string& ruta, vector<ParametroBarrido>& parametros,
+                               int& repeticiones, string& error) {
+    ifstream archivo(ruta);
+    if (!archivo) {
+        error = "No se pudo abrir " + ruta;
+        return false;
+    }
+    auto recortar = [](string texto) {
+        size_t inicio = texto.find_first_not_of(" \t\r");
+        size_t fin = texto.find_last_not_of(" \t\r");
+        return inicio == string::npos ? string() : texto.substr(inicio, fin - inicio + 1);
+    };
+    
+    string linea;
+    int numero_linea = 0;
+    while (getline(archivo, linea)) {
+        numero_linea++;
+        size_t comentario = linea.find('#');
+        if (comentario != string::npos) linea.erase(comentario);
+        linea = recortar(linea);
+        if (linea.empty()) continue;
         
-        // Bucle principal de simulación
-        while (true) {
-            auto tiempo_actual = chrono::steady_clock::now();
-            auto tiempo_total = chrono::duration_cast<chrono::seconds>(tiempo_actual - tiempo_inicio).count();
-            auto tiempo_desde_creacion = chrono::duration_cast<chrono::seconds>(tiempo_actual - ultima_creacion).count();
-            auto tiempo_desde_periodico = chrono::duration_cast<chrono::seconds>(tiempo_actual - ultimo_periodico).count();
-            
-            // Crear proceso cada 2 segundos
-            if (tiempo_desde_creacion >= 2 && procesos_creados < 8) {
-                if (!crearProceso()) {
-                    cout << COLOR_ERROR << "No se puede crear más procesos. Continuando simulación..." << COLOR_RESET << endl;
-                }
-                mostrarEstado();
-                ultima_creacion = tiempo_actual;
-            }
-            
-            // Hacer eventos periódicos cada 5 segundos después de 30 segundos
-            if (tiempo_total >= 10 && tiempo_desde_periodico >= 5) {
-                cout << COLOR_INFO << "\n--- EVENTOS PERIÓDICOS (cada 5 segundos) ---" << COLOR_RESET << endl;
-                
-                // Finalizar proceso aleatorio (solo si hay procesos)
-                if (procesos_creados > 0) {
-                    finalizarProcesoAleatorio();
-                    mostrarEstado();
-                }
-                
-                // Simular acceso a memoria
-                bool hay_activos = false;
-                for (const auto& p : procesos) {
-                    if (p.activo) {
-                        hay_activos = true;
-                        break;
-                    }
-                }
-                
-                if (hay_activos) {
-                    cout << COLOR_INFO << "--- ACCESO A MEMORIA ALEATORIO ---" << COLOR_RESET << endl;
-                    if (!simularAccesoMemoria()) {
-                        cout << COLOR_ERROR << "Error en acceso a memoria. Continuando..." << COLOR_RESET << endl;
-                    }
-                    mostrarEstado();
-                }
-                
-                ultimo_periodico = tiempo_actual;
+        size_t igual = linea.find('=');
+        if (igual == string::npos) {
+            error = "Línea " + to_string(numero_linea) + ": se esperaba clave = valores";
+            return false;
+        }
+        ParametroBarrido parametro;
+        parametro.clave = recortar(linea.substr(0, igual));
+        if (parametro.clave.compare(0, 2, "--") == 0) parametro.clave.erase(0, 2);
+        stringstream valores(linea.substr(igual + 1));
+        string valor;
+        while (getline(valores, valor, ',')) {
+            valor = recortar(valor);
+            if (!valor.empty()) parametro.valores.push_back(valor);
+        }
+        if (parametro.clave.empty() || parametro.valores.empty()) {
+            error = "Línea " + to_string(numero_linea) + ": clave o valores vacíos";
+            return false;
+        }
+        if (parametro.clave == "barrido" || parametro.clave == "hilos" || parametro.clave == "salida") {
+            error = "Línea " + to_string(numero_linea) + ": la opción " + parametro.clave + " no se puede barrer";
+            return false;
+        }
+        if (parametro.clave == "repeticiones") {
+            if (!leerEntero(parametro.valores[0], repeticiones) || repeticiones <= 0) {
+                error = "Línea " + to_string(numero_linea) + ": repeticiones debe ser positivo";
+                return false;
             }
-            
-            // Verificar si hay memoria disponible 
-            int ram_libre = count(marcos_ram.begin(), marcos_ram.end(), -1);
-            int swap_libre = count(marcos_swap.begin(), marcos_swap.end(), -1);
-            
-            if (ram_libre == 0 && swap_libre == 0) {
-                cout << COLOR_ERROR << "Memoria agotada. Finalizando simulación." << COLOR_RESET << endl;
-                break;
+            continue;
+        }
+        parametros.push_back(parametro);
+    }
+    return true;
+}
+
+// Conjunto de hilos con robo de trabajo: cada hilo tiene su propia cola de tareas,
+// toma las suyas por el final y, cuando se le acaban, roba por el frente de las
+// colas de los demás. Así los hilos no compiten por una única cola y las
+// simulaciones largas no dejan núcleos ociosos al final del barrido.
+class PoolTrabajo {
+private:
+    // Cola de un hilo (alineada para que dos colas no compartan línea de caché)
+    struct alignas(64) ColaHilo {
+        mutex cerrojo;
+        deque<size_t> tareas;
+    };
+    
+    vector<ColaHilo> colas;
+    atomic<unsigned long long> robos;
+    
+    // Toma la siguiente tarea: primero la propia, luego roba a los demás
+    bool siguienteTarea(size_t hilo, size_t& tarea) {
+        {
+            lock_guard<mutex> guardia(colas[hilo].cerrojo);
+            if (!colas[hilo].tareas.empty()) {
+                tarea = colas[hilo].tareas.back();
+                colas[hilo].tareas.pop_back();
+                return true;
             }
-            
-            // Terminar después de 60 segundos 
-            if (tiempo_total >= 60) {
-                cout << COLOR_INFO << "Tiempo de simulación completado. Finalizando." << COLOR_RESET << endl;
-                break;
+        }
+        for (size_t paso = 1; paso < colas.size(); ++paso) {
+            ColaHilo& victima = colas[(hilo + paso) % colas.size()];
+            lock_guard<mutex> guardia(victima.cerrojo);
+            if (!victima.tareas.empty()) {
+                tarea = victima.tareas.front();
+                victima.tareas.pop_front();
+                robos.fetch_add(1, memory_order_relaxed);
+                return true;
             }
-            
-            // Pausa para no sobrecargar la CPU
-            this_thread::sleep_for(chrono::milliseconds(500));
         }
+        return false; // Nadie agrega tareas durante la ejecución: no queda trabajo
+    }
+
+public:
+    explicit PoolTrabajo(size_t num_hilos) : colas(max<size_t>(num_hilos, 1)), robos(0) {}
+    
+    // Ejecuta tarea(i) para i en [0, num_tareas) y espera a que terminen todas
+    template <class Tarea>
+    void ejecutar(size_t num_tareas, const Tarea& tarea) {
+        for (size_t i = 0; i < num_tareas; ++i) {
+            colas[i % colas.size()].tareas.push_back(i);
+        }
+        vector<thread> hilos;
+        for (size_t h = 0; h < colas.size(); ++h) {
+            hilos.emplace_back([this, h, &tarea]() {
+                size_t indice;
+                while (siguienteTarea(h, indice)) tarea(indice);
+            });
+        }
+        for (thread& hilo : hilos) hilo.join();
+    }
+    
+    size_t numHilos() const { return colas.size(); }
+    unsigned long long numRobos() const { return robos.load(); }
+};
+
+// Escribe la tabla de resultados del barrido en CSV o JSON
+void escribirResultadosBarrido(ostream& salida, bool json, const vector<ConfiguracionSimulacion>& configuraciones,
+                               const vector<ResultadoSimulacion>& resultados, const vector<char>& completadas) {
+    static const char* columnas[] = {
+        "indice", "semilla", "politica", "carga", "memoria_mb", "pagina_mb", "proceso_min_mb", "proceso_max_mb",
+        "factor_virtual", "marcos_ram", "marcos_swap", "procesos_creados", "procesos_finalizados", "accesos",
+        "fallos_pagina", "tasa_fallos", "paginas_creadas", "eventos", "tiempo_simulado", "tiempo_real_s",
+        "tlb_entradas", "tlb_aciertos", "tlb_fallos", "tlb_derribos", "expulsiones", "anticipacion",
+        "anticipadas", "anticipadas_usadas", "anticipadas_sin_uso", "expulsiones_anticipacion", "marca_alta",
+        "expulsiones_fondo", "recuperacion_directa", "zswap_mb", "zswap_aciertos", "zswap_devueltas",
+        "razon_compresion", "fork", "biblioteca", "escrituras", "ksm", "forks", "copias_escritura",
+        "fusiones_ksm", "compartidas_pico", "demanda", "enormes", "fallos_demanda", "enormes_mapeadas",
+        "enormes_promovidas", "enormes_divididas", "nodos_tabla_pico", "conjunto_trabajo", "control_carga",
+        "demanda_pico", "sobrecargas", "suspensiones", "reanudaciones", "llegadas_diferidas", "rendimiento",
+        "completada"
+    };
+    const size_t num_columnas = sizeof(columnas) / sizeof(columnas[0]);
+    
+    if (json) salida << "[\n";
+    else {
+        for (size_t c = 0; c < num_columnas; ++c) salida << (c ? "," : "") << columnas[c];
+        salida << '\n';
+    }
+    
+    for (size_t i = 0; i < configuraciones.size(); ++i) {
+        const ConfiguracionSimulacion& config = configuraciones[i];
+        const ResultadoSimulacion& resultado = resultados[i];
+        double tasa_fallos = resultado.accesos ? double(resultado.fallos_pagina) / resultado.accesos : 0.0;
+        double factor = resultado.memoria_virtual_mb / (config.memoria_fisica / 1048576.0);
         
-        // Mostrar estadísticas finales
-        auto tiempo_final = chrono::steady_clock::now();
-        auto duracion_total = chrono::duration_cast<chrono::seconds>(tiempo_final - tiempo_inicio).count();
+        // Valores en el mismo orden que las columnas; los textos van entre comillas en JSON
+        vector<string> valores;
+        auto agregar = [&valores](const auto& valor) {
+            stringstream texto;
+            texto << valor;
+            valores.push_back(texto.str());
+        };
+        agregar(i);
+        agregar(config.semilla);
+        valores.push_back(config.politica);
+        valores.push_back(nombreModeloCarga(config.modelo_carga));
+        agregar(config.memoria_fisica / 1048576.0);
+        agregar(config.tamano_pagina / 1048576.0);
+        agregar(config.proceso_min / 1048576.0);
+        agregar(config.proceso_max / 1048576.0);
+        agregar(factor);
+        agregar(resultado.marcos_ram);
+        agregar(resultado.marcos_swap);
+        agregar(resultado.procesos_creados);
+        agregar(resultado.procesos_finalizados);
+        agregar(resultado.accesos);
+        agregar(resultado.fallos_pagina);
+        agregar(tasa_fallos);
+        agregar(resultado.paginas_creadas);
+        agregar(resultado.eventos_procesados);
+        agregar(resultado.tiempo_simulado);
+        agregar(resultado.tiempo_real);
+        agregar(config.tlb_entradas);
+        agregar(resultado.tlb_aciertos);
+        agregar(resultado.tlb_fallos);
+        agregar(resultado.tlb_derribos);
+        agregar(resultado.expulsiones);
+        agregar(config.paginas_anticipacion);
+        agregar(resultado.anticipadas);
+        agregar(resultado.aciertos_anticipados);
+        agregar(resultado.anticipadas_sin_uso);
+        agregar(resultado.expulsiones_anticipacion);
+        agregar(config.marca_alta);
+        agregar(resultado.expulsiones_fondo);
+        agregar(resultado.recuperacion_directa);
+        agregar(config.cache_comprimida_mb);
+        agregar(resultado.zswap_aciertos);
+        agregar(resultado.zswap_devueltas);
+        agregar(resultado.razon_compresion);
+        agregar(config.probabilidad_fork);
+        agregar(config.paginas_biblioteca);
+        agregar(config.fraccion_escrituras);
+        agregar(config.paginas_ksm);
+        agregar(resultado.forks);
+        agregar(resultado.copias_escritura);
+        agregar(resultado.fusiones_ksm);
+        agregar(resultado.compartidas_pico);
+        agregar(int(config.paginacion_demanda));
+        agregar(int(config.paginas_enormes));
+        agregar(resultado.fallos_demanda);
+        agregar(resultado.enormes_mapeadas);
+        agregar(resultado.enormes_promovidas);
+        agregar(resultado.enormes_divididas);
+        agregar(resultado.nodos_tabla_pico);
+        agregar(config.ventana_trabajo);
+        agregar(int(config.ventana_trabajo > 0 && config.control_carga));
+        agregar(resultado.demanda_pico);
+        agregar(resultado.sobrecargas);
+        agregar(resultado.suspensiones);
+        agregar(resultado.reanudaciones);
+        agregar(resultado.llegadas_diferidas);
+        agregar(resultado.rendimiento);
+        valores.push_back(completadas[i] ? "true" : "false");
         
-        cout << COLOR_INFO << "\n=== ESTADÍSTICAS FINALES ===" << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Procesos creados: " << procesos_creados << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Procesos finalizados: " << procesos_finalizados << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Fallos de página: " << fallos_pagina << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Páginas totales creadas: " << paginas.size() << COLOR_RESET << endl;
-        cout << COLOR_INFO << "Tiempo total de simulación: " << duracion_total << " segundos" << COLOR_RESET << endl;
-        cout << COLOR_INFO << "============================" << COLOR_RESET << endl;
+        if (json) {
+            salida << "  {";
+            for (size_t c = 0; c < num_columnas; ++c) {
+                bool texto = (c == 2 || c == 3);
+                salida << (c ? ", " : "") << '"' << columnas[c] << "\": "
+                       << (texto ? "\"" : "") << valores[c] << (texto ? "\"" : "");
+            }
+            salida << (i + 1 < configuraciones.size() ? "},\n" : "}\n");
+        } else {
+            for (size_t c = 0; c < num_columnas; ++c) salida << (c ? "," : "") << valores[c];
+            salida << '\n';
+        }
     }
-};
+    if (json) salida << "]\n";
+}
 
-// ============================================================================
-// FUNCIÓN PRINCIPAL - PUNTO DE ENTRADA DEL PROGRAMA
-// ============================================================================
+// Ejecuta el producto cartesiano de los valores de la especificación (por
+// repeticiones) como simulaciones independientes y silenciosas en paralelo. La
+// simulación i usa la semilla base + i, así el barrido es reproducible sin
+// importar cuántos hilos lo ejecuten.
+bool ejecutarBarrido(const ConfiguracionSimulacion& base) {
+    vector<ParametroBarrido> parametros;
+    int repeticiones = 1;
+    string error;
+    if (!leerEspecificacionBarrido(base.archivo_barrido, parametros, repeticiones, error)) {
+        cout << COLOR_ERROR << "Error en el barrido: " << error << COLOR_RESET << endl;
+        return false;
+    }
+    
+    // Con un estado de partida todas las simulaciones continúan desde él
+    ConfiguracionSimulacion guardada;
+    if (!base.archivo_restaurar_estado.empty() && !leerConfiguracionEstado(base.archivo_restaurar_estado, guardada, error)) {
+        cout << COLOR_ERROR << "Error: " << error << COLOR_RESET << endl;
+        return false;
+    }
+    
+    // Expandir el producto cartesiano (el primer parámetro varía más lento)
+    size_t combinaciones = 1;
+    for (const ParametroBarrido& parametro : parametros) combinaciones *= parametro.valores.size();
+    vector<ConfiguracionSimulacion> configuraciones;
+    configuraciones.reserve(combinaciones * repeticiones);
+    size_t descartadas = 0;
+    string primer_descarte;
+    
+    for (size_t combinacion = 0; combinacion < combinaciones; ++combinacion) {
+        ConfiguracionSimulacion config = base;
+        config.archivo_barrido.clear();
+        config.nivel_registro = "silencio";
+        
+        // Aplicar los valores como si fueran opciones de la línea de comandos
+        vector<string> opciones;
+        size_t resto = combinacion;
+        for (size_t p = parametros.size(); p-- > 0;) {
+            const ParametroBarrido& parametro = parametros[p];
+            opciones.push_back("--" + parametro.clave);
+            opciones.push_back(parametro.valores[resto % parametro.valores.size()]);
+            resto /= parametro.valores.size();
+        }
+        vector<char*> argumentos{nullptr};
+        for (string& opcion : opciones) argumentos.push_back(&opcion[0]);
+        if (!leerOpciones(argumentos.size(), argumentos.data(), config)) return false;
+        completarConfiguracionTraza(config);
+        // Las ejecuciones paralelas truncarían el mismo archivo: el barrido no escribe registros
+        config.archivo_registro_binario.clear();
+        config.archivo_registro.clear();
+        
+        error.clear();
+        if (!politicaConocida(config.politica)) error = "Política desconocida " + config.politica;
+        else validarConfiguracion(config, error);
+        if (error.empty() && !config.archivo_restaurar_estado.empty()) {
+            string opcion = opcionEstadoDistinta(guardada, config);
+            if (!opcion.empty()) error = "La opción " + opcion + " no puede cambiar al restaurar un estado";
+        }
+        if (!error.empty()) {
+            if (descartadas++ == 0) primer_descarte = error;
+            continue;
+        }
+        for (int r = 0; r < repeticiones; ++r) configuraciones.push_back(config);
+    }
+    for (size_t i = 0; i < configuraciones.size(); ++i) {
+        configuraciones[i].semilla = base.semilla + static_cast<unsigned int>(i);
+        if (!base.prefijo_metricas.empty()) {
+            configuraciones[i].prefijo_metricas = base.prefijo_metricas + "_" + to_string(i);
+        }
+        if (!base.archivo_swap.empty()) {
+            configuraciones[i].archivo_swap = base.archivo_swap + "_" + to_string(i);
+        }
+        if (!base.archivo_guardar_estado.empty()) {
+            configuraciones[i].archivo_guardar_estado = base.archivo_guardar_estado + "_" + to_string(i);
+        }
+    }
+    
+    if (descartadas > 0) {
+        cout << COLOR_INFO << "Combinaciones descartadas por ser inválidas: " << descartadas
+             << " (por ejemplo: " << primer_descarte << ")" << COLOR_RESET << endl;
+    }
+    if (configuraciones.empty()) {
+        cout << COLOR_ERROR << "Error: El barrido no tiene combinaciones válidas" << COLOR_RESET << endl;
+        return false;
+    }
+    
+    size_t num_hilos = base.hilos > 0 ? base.hilos : max(1u, thread::hardware_concurrency());
+    PoolTrabajo pool(min(num_hilos, configuraciones.size()));
+    cout << COLOR_INFO << "Barrido: " << configuraciones.size() << " simulaciones en "
+         << pool.numHilos() << " hilos" << COLOR_RESET << endl;
+    
+    // Cada simulación escribe solo su propia posición de los resultados
+    vector<ResultadoSimulacion> resultados(configuraciones.size());
+    vector<char> completadas(configuraciones.size(), 0);
+    auto inicio_real = chrono::steady_clock::now();
+    pool.ejecutar(configuraciones.size(), [&](size_t i) {
+        completadas[i] = ejecutarSimulacion(configuraciones[i], &resultados[i]);
+    });
+    double duracion_real = chrono::duration<double>(chrono::steady_clock::now() - inicio_real).count();
+    
+    // Escribir la tabla: JSON si el archivo termina en .json, si no CSV (por defecto en pantalla)
+    const string& ruta = base.archivo_resultados;
+    bool json = ruta.size() >= 5 && ruta.compare(ruta.size() - 5, 5, ".json") == 0;
+    if (ruta.empty()) {
+        escribirResultadosBarrido(cout, false, configuraciones, resultados, completadas);
+    } else {
+        ofstream salida(ruta);
+        if (!salida) {
+            cout << COLOR_ERROR << "Error: No se pudo crear " << ruta << COLOR_RESET << endl;
+            return false;
+        }
+        escribirResultadosBarrido(salida, json, configuraciones, resultados, completadas);
+        cout << COLOR_INFO << "Resultados escritos en " << ruta << COLOR_RESET << endl;
+    }
+    
+    size_t fallidas = count(completadas.begin(), completadas.end(), 0);
+    cout << COLOR_INFO << "Tiempo real: " << duracion_real << " s ("
+         << (duracion_real > 0 ? configuraciones.size() / duracion_real : 0.0) << " simulaciones/s, "
+         << pool.numRobos() << " tareas robadas";
+    if (fallidas > 0) cout << ", " << fallidas << " fallidas";
+    cout << ")" << COLOR_RESET << endl;
+    return true;
+}
 
-int main() {
+int main(int argc, char* argv[]) {
     cout << "=== SIMULADOR DE PAGINACIÓN - SISTEMAS OPERATIVOS ===" << endl;
-    cout << "Implementación de memoria virtual con política de reemplazo FIFO" << endl;
+    cout << "Implementación de memoria virtual con políticas de reemplazo intercambiables" << endl;
     cout << "================================================================" << endl;
     
-    int memoria_fisica, tamano_pagina, proceso_min, proceso_max;
+    // Modo benchmark de la tabla de páginas: --benchmark-pte [num_paginas]
+    if (argc >= 2 && string(argv[1]) == "--benchmark-pte") {
+        size_t num_paginas = (argc >= 3) ? strtoull(argv[2], nullptr, 10) : 10000000;
+        ejecutarBenchmarkPTE(num_paginas);
+        return 0;
+    }
     
-    // Solicitar parámetros de configuración al usuario
-    cout << "Tamaño memoria física (MB): ";
-    cin >> memoria_fisica;
-    cout << "Tamaño de página (MB): ";
-    cin >> tamano_pagina;
-    cout << "Tamaño mínimo de proceso (MB): ";
-    cin >> proceso_min;
-    cout << "Tamaño máximo de proceso (MB): ";
-    cin >> proceso_max;
+    // Conjunto de benchmarks del simulador: --benchmark [max_marcos] [resultados.csv|.json]
+    if (argc >= 2 && string(argv[1]) == "--benchmark") {
+        size_t max_marcos = (argc >= 3) ? strtoull(argv[2], nullptr, 10) : 10000000;
+        ejecutarBenchmarks(max_marcos, (argc >= 4) ? argv[3] : "");
+        return 0;
+    }
     
-    // Validaciones básicas de entrada
-    if (memoria_fisica <= 0 || tamano_pagina <= 0 || proceso_min <= 0 || proceso_max <= 0) {
-        cout << COLOR_ERROR << "Error: Todos los valores deben ser positivos" << COLOR_RESET << endl;
+    // Conversión de trazas de texto a binario: --convertir-traza entrada.txt salida.trz
+    if (argc >= 2 && string(argv[1]) == "--convertir-traza") {
+        if (argc != 4) {
+            cout << COLOR_ERROR << "Uso: --convertir-traza entrada.txt salida.trz" << COLOR_RESET << endl;
+            return 1;
+        }
+        return convertirTraza(argv[2], argv[3]) ? 0 : 1;
+    }
+    
+    ConfiguracionSimulacion config;
+    config.semilla = random_device{}(); // Semilla aleatoria salvo que se indique --semilla
+    if (!leerOpciones(argc, argv, config)) {
         return 1;
     }
     
-    if (proceso_min > proceso_max) {
-        cout << COLOR_ERROR << "Error: El tamaño mínimo no puede ser mayor al máximo" << COLOR_RESET << endl;
+    // Estado guardado: se parte de su configuración y las opciones entregadas la modifican
+    // (la semilla guardada continúa la misma simulación; otra semilla, una continuación distinta)
+    if (!config.archivo_restaurar_estado.empty()) {
+        string error;
+        if (!leerConfiguracionEstado(config.archivo_restaurar_estado, config, error)) {
+            cout << COLOR_ERROR << "Error: " << error << COLOR_RESET << endl;
+            return 1;
+        }
+        if (!leerOpciones(argc, argv, config)) {
+            return 1;
+        }
+    }
+    
+    // Barrido de parámetros: muchas simulaciones independientes en paralelo, sin preguntas
+    if (!config.archivo_barrido.empty()) {
+        return ejecutarBarrido(config) ? 0 : 1;
+    }
+    
+    completarConfiguracionTraza(config);
+    
+    // Solicitar al usuario los parámetros que no se entregaron como opciones (un tamaño
+    // inválido queda en 0 y lo rechaza la validación)
+    auto preguntarTamano = [](const char* pregunta, uint64_t& tamano) {
+        if (tamano != 0) return;
+        string respuesta;
+        cout << pregunta << " (MB o con sufijo K, M, G): ";
+        cin >> respuesta;
+        if (!leerTamano(respuesta, tamano)) tamano = 0;
+    };
+    preguntarTamano("Tamaño memoria física", config.memoria_fisica);
+    preguntarTamano("Tamaño de página", config.tamano_pagina);
+    preguntarTamano("Tamaño mínimo de proceso", config.proceso_min);
+    preguntarTamano("Tamaño máximo de proceso", config.proceso_max);
+    
+    // Validaciones básicas de entrada
+    string error;
+    if (!validarConfiguracion(config, error)) {
+        cout << COLOR_ERROR << "Error: " << error << COLOR_RESET << endl;
         return 1;
     }
     
+    // Modo concurrente: cada grupo de procesos en su propio hilo
+    if (config.modo_concurrente) {
+        return ejecutarSimulacionConcurrente(config) ? 0 : 1;
+    }
+    
     // Crear y ejecutar el simulador
-    SimuladorMemoria simulador(memoria_fisica, tamano_pagina, proceso_min, proceso_max);
-    simulador.ejecutarSimulacion();
+    if (!ejecutarSimulacion(config)) {
+        return 1;
+    }
     
     return 0;
-}
\ No newline at end of file
+}